@@ -9,6 +9,18 @@
 #include "../src/Component.h"
 #include "../src/System.h"
 #include "../src/Parser.h"
+#include "../src/DynamicBuffer.h"
+#include "../src/DoubleBuffered.h"
+#include "../src/Prefab.h"
+#include "../src/Replication.h"
+#include "../src/Transform.h"
+#include "../src/SpatialGrid.h"
+#include "../src/Interest.h"
+#include "../src/ShardedWorld.h"
+#include "../src/WorldStats.h"
+#include "../src/Reflection.h"
+#include "../src/Parallel.h"
+#include "../src/Events.h"
 
 
 #endif // !ECS_H
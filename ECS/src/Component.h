@@ -5,6 +5,10 @@
 
 #include "ECS_Definitions.h"
 
+#include <map>
+#include <mutex>
+#include <vector>
+
 namespace ECS {
 
 	
@@ -16,6 +20,7 @@ namespace ECS {
 		Component& operator=(Component&&) = delete;
 
 		friend class ComponentManager;
+		friend class ComponentGroup;
 		
 		// The owning entity's id
 		EntityId				m_ownerId;
@@ -29,9 +34,15 @@ namespace ECS {
 		// This component's unique type identifier
 		uint64_t				m_componentType;
 
+		// The index of this component inside the ComponentMap vector of its type
+		uint64_t				m_componentMapIndex;
+
 		// Used by the ComponentManager to show when a component is ready to be cleaned up
 		bool					m_bMarkedForCleanUp;
 
+		// Disabled components stay attached to their entity, but are skipped when systems iterate
+		bool					m_bEnabled;
+
 	public:
 
 
@@ -40,7 +51,9 @@ namespace ECS {
 			m_componentId( 0 ),
 			m_componentManagerId( 0 ),
 			m_componentType( componentType ),
-			m_bMarkedForCleanUp( false )
+			m_componentMapIndex( 0 ),
+			m_bMarkedForCleanUp( false ),
+			m_bEnabled( true )
 		{};
 
 		virtual ~Component() {}
@@ -51,6 +64,57 @@ namespace ECS {
 
 		inline const uint64_t& GetComponentType() const { return m_componentType; }
 
+		inline bool IsEnabled() const { return m_bEnabled; }
+
+		// Enables or disables this component, this is not a structural change so no system is notified
+		inline void SetEnabled( bool bEnabled ) { m_bEnabled = bEnabled; }
+
+		/*
+		*	Called when this component is moved into another world, components that store EntityIds must translate them here
+		*	@param	remap:	The EntityId in the new world of each old EntityId, indexed by the old EntityId, 0 for entities that were not moved
+		*/
+		virtual void RemapEntityReferences( const std::vector<EntityId>& /*remap*/ ) {}
+
+	};
+
+
+	/*
+	*	Remembers sizeof( T ) of each component type created through a typed API, so memory statistics can report bytes per type
+	*	Sizes are shared by every World, as a component type always has the same size
+	*/
+	class ComponentSizes
+	{
+	public:
+		ComponentSizes() = delete;	// Static class, no constructor needed
+
+		// Records the size of <T>, only the first call for each type takes the lock
+		template<typename T>
+		static inline void Record()
+		{
+			static const bool bRecorded = Set( T::ID, sizeof( T ) );
+			( void )bRecorded;
+		}
+
+		// Returns the recorded size of the passed component type, 0 if it has not been recorded
+		static size_t Get( uint64_t componentType )
+		{
+			std::lock_guard<std::mutex> lock( s_mutex );
+			auto it = s_sizes.find( componentType );
+			return it != s_sizes.end() ? it->second : 0;
+		}
+
+	private:
+
+		static bool Set( uint64_t componentType, size_t size )
+		{
+			std::lock_guard<std::mutex> lock( s_mutex );
+			s_sizes[componentType] = size;
+			return true;
+		}
+
+		static inline std::mutex s_mutex;
+
+		static inline std::map<uint64_t, size_t> s_sizes;
 	};
 
 
@@ -0,0 +1,218 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef COMPONENTGROUP_H
+#define COMPONENTGROUP_H
+
+#include "ECS_Definitions.h"
+#include "Entity.h"
+#include "Component.h"
+
+#include <array>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ECS
+{
+	/*
+	*	An owning group keeps the ComponentMap vectors of its component types co-sorted
+	*	Entities that have every owned type occupy the same prefix [0, GetSize()) of each vector, at the same index,
+	*	so iterating the group is a linear walk over each vector with no searching
+	*	A component type can only be owned by a single group
+	*/
+	class ComponentGroup
+	{
+		friend class ComponentManager;
+
+	protected:
+
+		// The owned component types
+		std::vector<uint64_t>					m_types;
+
+		// The ComponentMap vector of each owned type, in the same order as m_types
+		std::vector<std::vector<Component*>*>	m_pools;
+
+		// Number of entities in the group, the length of the shared prefix
+		size_t									m_size;
+
+	public:
+
+		ComponentGroup( const std::vector<uint64_t>& types, const std::vector<std::vector<Component*>*>& pools ) :
+			m_types( types ),
+			m_pools( pools ),
+			m_size( 0 )
+		{}
+
+		virtual ~ComponentGroup() {}
+
+		ComponentGroup( const ComponentGroup& ) = delete;
+		ComponentGroup& operator=( const ComponentGroup& ) = delete;
+		ComponentGroup( ComponentGroup&& ) = delete;
+		ComponentGroup& operator=( ComponentGroup&& ) = delete;
+
+		inline size_t GetSize() const { return m_size; }
+
+		// Returns true, if the group owns the passed component type
+		inline bool Owns( uint64_t componentType ) const
+		{
+			for( uint64_t type : m_types )
+			{
+				if( type == componentType )
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		inline const std::vector<uint64_t>& GetTypes() const { return m_types; }
+
+	private:
+
+		// Called after a component of an owned type has been added to the entity, moving the entity into the group if it now matches
+		void OnComponentAdded( const Entity& entity )
+		{
+			std::array<Component*, MAX_GROUP_TYPES> components;
+			if( !FindOwnedComponents( entity, components ) )
+			{
+				return;
+			}
+
+			if( components[0]->m_componentMapIndex < m_size )	// Already in the group
+			{
+				return;
+			}
+
+			for( size_t t = 0; t < m_types.size(); ++t )
+			{
+				Swap( *m_pools[t], components[t]->m_componentMapIndex, m_size );
+			}
+			++m_size;
+		}
+
+		// Called before the passed component of an owned type is removed, moving its entity out of the group if it was in it
+		void OnComponentRemoving( const Entity& entity, const Component* component )
+		{
+			if( component->m_componentMapIndex >= m_size )	// Not part of the group
+			{
+				return;
+			}
+
+			std::array<Component*, MAX_GROUP_TYPES> components;
+			if( !FindOwnedComponents( entity, components ) )
+			{
+				return;
+			}
+
+			--m_size;
+			for( size_t t = 0; t < m_types.size(); ++t )
+			{
+				Swap( *m_pools[t], components[t]->m_componentMapIndex, m_size );
+			}
+		}
+
+		// Finds the entity's component of each owned type, preferring the component that is already inside the group
+		bool FindOwnedComponents( const Entity& entity, std::array<Component*, MAX_GROUP_TYPES>& components ) const
+		{
+			components.fill( nullptr );
+
+			const uint64_t componentCount = entity.GetComponentCount();
+			uint64_t visited = 0;
+			for( Component* c : entity.GetComponents() )
+			{
+				if( visited == componentCount )
+				{
+					break;
+				}
+
+				if( c == nullptr )	// Removing all components can leave holes, keep looking until every component has been visited
+				{
+					continue;
+				}
+				++visited;
+
+				for( size_t t = 0; t < m_types.size(); ++t )
+				{
+					if( m_types[t] == c->m_componentType && ( components[t] == nullptr || c->m_componentMapIndex < m_size ) )
+					{
+						components[t] = c;
+					}
+				}
+			}
+
+			for( size_t t = 0; t < m_types.size(); ++t )
+			{
+				if( components[t] == nullptr )
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		static inline void Swap( std::vector<Component*>& pool, uint64_t a, uint64_t b )
+		{
+			if( a == b )
+			{
+				return;
+			}
+
+			std::swap( pool[a], pool[b] );
+			pool[a]->m_componentMapIndex = a;
+			pool[b]->m_componentMapIndex = b;
+		}
+
+	};
+
+
+	/*
+	*	Typed view of an owning group
+	*/
+	template<typename ... Owned>
+	class Group : public ComponentGroup
+	{
+	public:
+
+		explicit Group( const std::vector<std::vector<Component*>*>& pools ) :
+			ComponentGroup( { Owned::ID ... }, pools )
+		{}
+
+		virtual ~Group() {}
+
+		/*
+		*	Calls the passed function with the components of every entity in the group
+		*	@param	Function:	Callable taking ( Owned* ... )
+		*/
+		template<typename Function>
+		void ForEach( Function&& function )
+		{
+			ForEach( std::forward<Function>( function ), std::index_sequence_for<Owned ...>() );
+		}
+
+		// Returns the component of the owned type at the passed group position
+		template<size_t INDEX>
+		inline auto* Get( size_t position ) const
+		{
+			using ComponentClass = std::tuple_element_t<INDEX, std::tuple<Owned ...>>;
+			return static_cast<ComponentClass*>( ( *m_pools[INDEX] )[position] );
+		}
+
+	private:
+
+		template<typename Function, size_t ... INDEX>
+		void ForEach( Function&& function, std::index_sequence<INDEX ...> )
+		{
+			Component** pools[] = { m_pools[INDEX]->data() ... };
+
+			const size_t size = m_size;
+			for( size_t i = 0; i < size; ++i )
+			{
+				function( static_cast<Owned*>( pools[INDEX][i] ) ... );
+			}
+		}
+
+	};
+
+}
+
+#endif // !COMPONENTGROUP_H
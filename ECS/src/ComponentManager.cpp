@@ -2,11 +2,23 @@
 
 #include "ComponentManager.h"
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+
 namespace ECS
 {
 
 	ComponentManager::~ComponentManager()
 	{
+		for( ComponentGroup* group : m_groups )
+		{
+			delete group, group = nullptr;
+		}
+		m_groups.clear();
+		m_groupOwners.clear();
+
 		RemoveAllComponentsOnManager();
 		CleanUpComponents();
 	}
@@ -32,6 +44,478 @@ namespace ECS
 		}
 	}
 
+	size_t ComponentManager::InstantiatePrefab( const Prefab& prefab, const std::vector<EntityId>& entities )
+	{
+		const size_t componentsPerEntity = prefab.m_components.size();
+
+		// Reserve once, so the ComponentMap vectors do not grow one component at a time
+		for( const IPrefabComponent* prefabComponent : prefab.m_components )
+		{
+			std::vector<Component*>& components = m_componentMap[prefabComponent->GetComponentType()];
+			components.reserve( components.size() + entities.size() );
+		}
+
+		size_t instantiated = 0;
+		for( EntityId entityId : entities )
+		{
+			if( m_componentCounter + componentsPerEntity > MAX_COMPONENTS )	// We are at capacity
+			{
+				break;
+			}
+
+			auto it = m_entityManager->m_entities.find( entityId );
+			if( it == m_entityManager->m_entities.end() || it->second == nullptr )	// Entity does not exist
+			{
+				continue;
+			}
+
+			Entity* entity = it->second;
+			if( entity->m_componentCounter + componentsPerEntity > MAX_COMPONENTS_PER_ENTITY )	// This entity would be over its capacity
+			{
+				continue;
+			}
+
+			for( const IPrefabComponent* prefabComponent : prefab.m_components )
+			{
+				Component* component = prefabComponent->Clone();
+				if( component != nullptr )
+				{
+					AttachComponent( *entity, component );
+				}
+			}
+
+			for( size_t i = 0; i < MAX_TAGS; ++i )
+			{
+				if( prefab.m_tags.test( i ) )
+				{
+					m_entityManager->SetTag( entityId, i, true );
+				}
+			}
+
+			if( m_systemManager )
+			{
+				// A single notification for all of the components added to this entity
+				m_systemManager->OnEntitySignatureChanged( *entity );
+			}
+
+			++instantiated;
+		}
+
+		return instantiated;
+	}
+
+	bool ComponentManager::HasComponentType( EntityId entityId, uint64_t componentType ) const
+	{
+		auto it = m_entityManager->m_entities.find( entityId );
+		if( it == m_entityManager->m_entities.end() || it->second == nullptr )	// Entity does not exist
+		{
+			return false;
+		}
+
+		const Entity& entity = *it->second;
+		uint64_t visited = 0;
+		for( const Component* c : entity.m_components )
+		{
+			if( visited == entity.m_componentCounter )
+			{
+				break;
+			}
+
+			if( c == nullptr )
+			{
+				continue;
+			}
+			++visited;
+
+			if( c->m_componentType == componentType )
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	size_t ComponentManager::AttachComponents( EntityId entityId, const std::vector<Component*>& components )
+	{
+		auto it = m_entityManager->m_entities.find( entityId );
+		Entity* entity = it != m_entityManager->m_entities.end() ? it->second : nullptr;
+
+		size_t attached = 0;
+		for( Component* component : components )
+		{
+			if( entity == nullptr || m_componentCounter >= MAX_COMPONENTS || entity->m_componentCounter >= MAX_COMPONENTS_PER_ENTITY )	// Does not fit
+			{
+				delete component, component = nullptr;
+				continue;
+			}
+
+			AttachComponent( *entity, component );
+			++attached;
+		}
+
+		if( m_systemManager && attached > 0 )
+		{
+			// A single notification for all of the components added to this entity
+			m_systemManager->OnEntitySignatureChanged( *entity );
+		}
+
+		return attached;
+	}
+
+	size_t ComponentManager::MergeFrom( ComponentManager& source, const std::vector<EntityId>& entities, std::vector<EntityId>& remap )
+	{
+		// Decide which entities fit first, so references to entities that stay behind are remapped to 0 as well
+		std::vector<std::pair<Entity*, Entity*>> mergedEntities;
+		std::unordered_map<uint64_t, size_t> typeCounts;
+		uint64_t componentCounter = m_componentCounter;
+		for( EntityId sourceId : entities )
+		{
+			if( sourceId >= remap.size() || remap[sourceId] == 0 || !source.m_entityManager->Exists( sourceId ) || !m_entityManager->Exists( remap[sourceId] ) )
+			{
+				continue;
+			}
+
+			Entity* sourceEntity = source.m_entityManager->m_entities[sourceId];
+			Entity* entity = m_entityManager->m_entities[remap[sourceId]];
+			if( componentCounter + sourceEntity->m_componentCounter > MAX_COMPONENTS
+				|| entity->m_componentCounter + sourceEntity->m_componentCounter > MAX_COMPONENTS_PER_ENTITY )	// Would be over capacity
+			{
+				remap[sourceId] = 0;
+				continue;
+			}
+
+			uint64_t counted = 0;
+			for( Component* c : sourceEntity->m_components )
+			{
+				if( counted == sourceEntity->m_componentCounter )
+				{
+					break;
+				}
+
+				if( c != nullptr )
+				{
+					++typeCounts[c->m_componentType];
+					++counted;
+				}
+			}
+
+			componentCounter += sourceEntity->m_componentCounter;
+			mergedEntities.emplace_back( sourceEntity, entity );
+		}
+
+		// Grow once per component type, so each type's components are appended as one block
+		for( const auto& pair : typeCounts )
+		{
+			std::vector<Component*>& components = m_componentMap[pair.first];
+			components.reserve( components.size() + pair.second );
+		}
+
+		std::vector<Component*> moved;
+		for( const auto& pair : mergedEntities )
+		{
+			Entity* sourceEntity = pair.first;
+
+			moved.clear();
+			for( Component* c : sourceEntity->m_components )
+			{
+				if( moved.size() == sourceEntity->m_componentCounter )
+				{
+					break;
+				}
+
+				if( c != nullptr )
+				{
+					moved.push_back( c );
+				}
+			}
+
+			// Detach the components from the source storage, while the entity still owns them so groups can find its other components
+			for( Component* c : moved )
+			{
+				source.RemoveFromComponentMap( *sourceEntity, c );
+				source.RemoveFromComponentArray( c );
+			}
+
+			for( Component* c : moved )
+			{
+				sourceEntity->m_components[c->m_componentId] = nullptr;
+			}
+			sourceEntity->m_componentCounter = 0;
+
+			if( source.m_systemManager )
+			{
+				source.m_systemManager->OnEntitySignatureChanged( *sourceEntity );
+			}
+
+			for( Component* c : moved )
+			{
+				c->RemapEntityReferences( remap );
+				AttachComponent( *pair.second, c );
+			}
+		}
+
+		if( m_systemManager )
+		{
+			for( const auto& pair : mergedEntities )
+			{
+				m_systemManager->OnEntitySignatureChanged( *pair.second );
+			}
+		}
+
+		return mergedEntities.size();
+	}
+
+	void ComponentManager::AttachComponent( Entity& entity, Component* component )
+	{
+		component->m_ownerId = entity.m_entityId;
+		component->m_componentId = entity.m_componentCounter;
+		++entity.m_componentCounter;
+		entity.m_components[component->m_componentId] = component;
+
+		component->m_componentManagerId = this->m_componentCounter;
+		m_components[component->m_componentManagerId] = component;
+		++this->m_componentCounter;
+
+		// Also add a reference of this component to the ComponentMap
+		std::vector<Component*>& components = m_componentMap[component->m_componentType];
+		component->m_componentMapIndex = components.size();
+		components.push_back( component );
+
+		if( !m_groupOwners.empty() )
+		{
+			auto it = m_groupOwners.find( component->m_componentType );
+			if( it != m_groupOwners.end() )
+			{
+				it->second->OnComponentAdded( entity );
+			}
+		}
+
+		m_observers.RecordAdded( component->m_componentType, entity.m_entityId );
+	}
+
+	void ComponentManager::RemoveFromComponentMap( const Entity& entity, Component* component )
+	{
+		m_observers.RecordRemoved( component->m_componentType, entity.m_entityId );
+
+		if( !m_groupOwners.empty() )
+		{
+			auto it = m_groupOwners.find( component->m_componentType );
+			if( it != m_groupOwners.end() )
+			{
+				it->second->OnComponentRemoving( entity, component );
+			}
+		}
+
+		std::vector<Component*>& components = m_componentMap[component->m_componentType];
+
+		// Outside of any group prefix now, so swapping the last component in keeps every group intact
+		const uint64_t index = component->m_componentMapIndex;
+		components[index] = components.back();
+		components[index]->m_componentMapIndex = index;
+		components.pop_back();
+	}
+
+	void ComponentManager::RemoveFromComponentArray( Component* component )
+	{
+		// Swap the last component of the array into the removed component's slot
+		const uint64_t componentId = component->m_componentManagerId;
+		const uint64_t lastComponentId = --m_componentCounter;
+
+		m_components[componentId] = m_components[lastComponentId];
+		m_components[lastComponentId] = nullptr;
+
+		if( m_components[componentId] != nullptr )
+		{
+			m_components[componentId]->m_componentManagerId = componentId;
+		}
+	}
+
+	void ComponentManager::SortIntoGroup( ComponentGroup* group )
+	{
+		const std::vector<Component*> firstPool = *group->m_pools[0];
+		for( Component* component : firstPool )
+		{
+			auto it = m_entityManager->m_entities.find( component->m_ownerId );
+			if( it != m_entityManager->m_entities.end() && it->second != nullptr )
+			{
+				group->OnComponentAdded( *it->second );
+			}
+		}
+	}
+
+	bool ComponentManager::Compact( float timeBudget )
+	{
+		using Clock = std::chrono::steady_clock;
+		const Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>( std::chrono::duration<float>( timeBudget ) );
+
+		// Orders components by owner, and by their slot on the owner for entities with several components of one type
+		const auto byOwner = []( const Component* a, const Component* b )
+		{
+			return a->m_ownerId != b->m_ownerId ? a->m_ownerId < b->m_ownerId : a->m_componentId < b->m_componentId;
+		};
+
+		// Entities are cheap to check, so the clock is only read once per batch of them
+		static constexpr uint32_t ENTITIES_PER_UNIT = 64;
+
+		do
+		{
+			switch( m_compactionPhase )
+			{
+			case CompactionPhase::EntityComponents:
+			{
+				auto it = m_entityManager->m_entities.lower_bound( m_compactionCursor );
+				for( uint32_t i = 0; i < ENTITIES_PER_UNIT && it != m_entityManager->m_entities.end(); ++i, ++it )
+				{
+					if( it->second != nullptr && CompactEntityComponents( *it->second ) && m_systemManager )
+					{
+						// Systems may have missed components behind the hole
+						m_systemManager->OnEntitySignatureChanged( *it->second );
+					}
+				}
+
+				if( it == m_entityManager->m_entities.end() )
+				{
+					m_compactionPhase = CompactionPhase::ComponentMap;
+					m_compactionCursor = 0;
+				}
+				else
+				{
+					m_compactionCursor = it->first;
+				}
+				break;
+			}
+
+			case CompactionPhase::ComponentMap:
+			{
+				auto it = m_componentMap.lower_bound( m_compactionCursor );
+				if( it == m_componentMap.end() )
+				{
+					m_compactionPhase = CompactionPhase::ComponentArray;
+					m_compactionCursor = 0;
+					break;
+				}
+
+				// Grouped types keep the order their group gives them
+				std::vector<Component*>& components = it->second;
+				if( m_groupOwners.find( it->first ) == m_groupOwners.end() )
+				{
+					std::sort( components.begin(), components.end(), byOwner );
+					for( size_t i = 0; i < components.size(); ++i )
+					{
+						components[i]->m_componentMapIndex = i;
+					}
+
+					// Give back what a wave of destroyed entities left behind
+					if( components.capacity() > 2 * components.size() + 64 )
+					{
+						components.shrink_to_fit();
+					}
+				}
+
+				if( it->first == UINT64_MAX )
+				{
+					m_compactionPhase = CompactionPhase::ComponentArray;
+					m_compactionCursor = 0;
+				}
+				else
+				{
+					m_compactionCursor = it->first + 1;
+				}
+				break;
+			}
+
+			case CompactionPhase::ComponentArray:
+			{
+				std::sort( m_components.begin(), m_components.begin() + m_componentCounter, byOwner );
+				for( uint64_t i = 0; i < m_componentCounter; ++i )
+				{
+					m_components[i]->m_componentManagerId = i;
+				}
+
+				m_compactionPhase = CompactionPhase::Systems;
+				m_compactionCursor = 0;
+				break;
+			}
+
+			case CompactionPhase::Systems:
+			{
+				if( m_systemManager && m_systemManager->SortSystemEntities( m_compactionCursor ) )
+				{
+					++m_compactionCursor;
+				}
+				else
+				{
+					m_compactionPhase = CompactionPhase::FreeEntityIds;
+					m_compactionCursor = 0;
+				}
+				break;
+			}
+
+			case CompactionPhase::FreeEntityIds:
+			{
+				// Popped from the back, so the lowest EntityIds are reused first and live entities stay dense
+				std::vector<EntityId>& freeEntityIds = m_entityManager->m_freeEntityIds;
+				std::sort( freeEntityIds.begin(), freeEntityIds.end(), std::greater<EntityId>() );
+
+				m_compactionPhase = CompactionPhase::EntityComponents;
+				m_compactionCursor = 0;
+				return true;
+			}
+			}
+		}
+		while( Clock::now() < deadline );
+
+		return false;
+	}
+
+	void ComponentManager::CollectStats( WorldStats& stats ) const
+	{
+		stats.m_componentCount = m_componentCounter;
+		stats.m_componentCapacity = MAX_COMPONENTS;
+		stats.m_componentsPendingCleanUp = m_componentsMarkedForCleanUp.size();
+		stats.m_componentArrayBytes = sizeof( m_components );
+
+		for( const auto& pair : m_componentMap )
+		{
+			const std::vector<Component*>& components = pair.second;
+
+			ComponentTypeStats type;
+			type.m_componentType = pair.first;
+			type.m_count = components.size();
+			type.m_componentSize = ComponentSizes::Get( pair.first );
+			type.m_bytesUsed = type.m_count * ( type.m_componentSize + sizeof( Component* ) );
+			type.m_bytesAllocated = type.m_count * type.m_componentSize + components.capacity() * sizeof( Component* );
+			type.m_bGrouped = m_groupOwners.find( pair.first ) != m_groupOwners.end();
+			stats.m_componentTypes.push_back( type );
+		}
+	}
+
+	bool ComponentManager::CompactEntityComponents( Entity& entity )
+	{
+		bool bClosedHole = false;
+
+		uint64_t next = 0;
+		for( uint64_t i = 0; i < MAX_COMPONENTS_PER_ENTITY && next < entity.m_componentCounter; ++i )
+		{
+			Component* c = entity.m_components[i];
+			if( c == nullptr )
+			{
+				continue;
+			}
+
+			if( i != next )
+			{
+				entity.m_components[next] = c;
+				entity.m_components[i] = nullptr;
+				c->m_componentId = next;
+				bClosedHole = true;
+			}
+			++next;
+		}
+
+		return bClosedHole;
+	}
+
 	void ComponentManager::RemoveAllComponentsOnManager()
 	{
 		for( size_t i = 0; i < m_components.size(); i++ )
@@ -66,8 +550,7 @@ namespace ECS
 			{
 
 				// Remove the component, from the ComponentMap Vector, replacing the component to be removed with last component in the vector
-				m_componentMap[componentType][i] = m_componentMap[componentType][size - 1];
-				m_componentMap[componentType].pop_back();
+				RemoveFromComponentMap( entity, component );
 
 				ComponentId componentId = component->m_componentId;
 
@@ -6,6 +6,9 @@
 #include "Utility/TemplateHelper.h"
 #include "Component.h"
 #include "EntityManager.h"
+#include "Prefab.h"
+#include "ComponentGroup.h"
+#include "ComponentObserver.h"
 #include "SystemManager.h"
 
 #include <array>
@@ -21,6 +24,9 @@ namespace ECS
 	*/
 	class ComponentManager
 	{
+		friend class RollbackBuffer;
+		friend class ReplicationEncoder;
+
 		// All Components created by this component manager
 		std::array<Component*, MAX_COMPONENTS> m_components;
 
@@ -41,6 +47,31 @@ namespace ECS
 		// System Manager reference
 		SystemManager* m_systemManager;
 
+		// Owning groups created on this component manager
+		std::vector<ComponentGroup*> m_groups;
+
+		// The group that owns each grouped component type
+		std::map< uint64_t /*Component Type*/, ComponentGroup* > m_groupOwners;
+
+		// Batched OnAdded / OnRemoved observers, fed by every component add and remove
+		ComponentObservers		m_observers;
+
+		// The steps of the incremental compaction pass, run in this order
+		enum class CompactionPhase : uint8_t
+		{
+			EntityComponents,	// Close holes in each entity's component array
+			ComponentMap,		// Sort each ComponentMap vector by owning EntityId
+			ComponentArray,		// Sort the array of all components by owning EntityId
+			Systems,			// Sort each system's matched entities by EntityId
+			FreeEntityIds		// Hand out the lowest free EntityIds first
+		};
+
+		// The step the compaction pass continues from
+		CompactionPhase			m_compactionPhase;
+
+		// Where the current step continues from: an EntityId, a component type or a system index
+		uint64_t				m_compactionCursor;
+
 
 	public:
 
@@ -48,7 +79,12 @@ namespace ECS
 			m_components(),
 			m_componentCounter( 0 ),
 			m_entityManager( entityManager ),
-			m_systemManager( systemManager )
+			m_systemManager( systemManager ),
+			m_groups(),
+			m_groupOwners(),
+			m_observers(),
+			m_compactionPhase( CompactionPhase::EntityComponents ),
+			m_compactionCursor( 0 )
 		{}
 
 		~ComponentManager();
@@ -84,6 +120,8 @@ namespace ECS
 				return nullptr;
 			}
 
+			ComponentSizes::Record<T>();
+
 			// Component Classes can support different constructors, 0 -> n number of paramters in their constructor
 			T* component = new T( std::forward<Args>( args ) ... );
 
@@ -92,17 +130,7 @@ namespace ECS
 				return nullptr;
 			}
 
-			component->m_ownerId = entityId;
-			component->m_componentId = entity->m_componentCounter;
-			++entity->m_componentCounter;
-			entity->m_components[component->m_componentId] = component;
-
-			component->m_componentManagerId = this->m_componentCounter;
-			m_components[component->m_componentManagerId] = component;
-			++this->m_componentCounter;
-
-			// Also add a reference of this component to the ComponentMap
-			m_componentMap[T::ID].push_back( component );
+			AttachComponent( *entity, component );
 
 			if( m_systemManager )
 			{
@@ -155,6 +183,17 @@ namespace ECS
 			return nullptr;
 		}
 
+		// Returns true, if the entity with the passed EntityId has a component of the passed type
+		bool HasComponentType( EntityId entityId, uint64_t componentType ) const;
+
+		inline ComponentObservers& GetObservers() { return m_observers; }
+
+		// Returns every component of the passed type, in ComponentMap order
+		inline const std::vector<Component*>& GetComponentsOfType( uint64_t componentType )
+		{
+			return m_componentMap[componentType];
+		}
+
 		/*
 		*	Removes the passed component type from the entity with the passed entity id
 		*	@param	<T>:		The type of Component to remove, if multiple components of the same type exist, the first component of type <T> found will be removed
@@ -190,8 +229,7 @@ namespace ECS
 				{
 
 					// Remove the component, from the ComponentMap Vector, replacing the component to be removed with last component in the vector
-					m_componentMap[T::ID][i] = m_componentMap[T::ID][size - 1];
-					m_componentMap[T::ID].pop_back();
+					RemoveFromComponentMap( *entity, component );
 
 					ComponentId componentId = component->m_componentId;
 
@@ -242,9 +280,140 @@ namespace ECS
 		*/
 		void RemoveAllComponents( EntityId entityId );
 
+		/*
+		*	Gives each of the passed entities a copy of every component on the prefab
+		*	Systems are notified once per entity, after all of its components have been added
+		*	@param	Prefab:		The prefab to copy components from
+		*	@param	vector:		The entity ids of the entities to add the components to
+		*	@return	size_t:		The number of entities that received the prefab's components
+		*/
+		size_t InstantiatePrefab( const Prefab& prefab, const std::vector<EntityId>& entities );
+
+		/*
+		*	Attaches already created components to the entity with the passed EntityId, taking ownership of them
+		*	Systems are notified once, after all of the components have been attached
+		*	@param	EntityId:	The entity id of the entity to add the components to
+		*	@param	vector:		The components to attach, components that do not fit are deleted
+		*	@return	size_t:		The number of components attached
+		*/
+		size_t AttachComponents( EntityId entityId, const std::vector<Component*>& components );
+
+		/*
+		*	Moves the components of the passed entities of the source component manager onto their remapped entity of this manager
+		*	Component objects are moved, not copied, the ComponentMap vectors are grown once per component type
+		*	Entities whose components do not fit within this manager's capacity keep them, and their remap entry is set to 0
+		*	Systems of both managers are notified once per moved entity, the cost only depends on the moved entities and their components
+		*	@param	ComponentManager:	The manager to take components from, its remaining components stay with it
+		*	@param	entities:	The EntityIds, in the source manager, of the entities to move, each with a remap entry
+		*	@param	remap:		The EntityId in this manager of each EntityId in the source manager, 0 for entities that are not moved
+		*	@return	size_t:		The number of entities whose components were moved
+		*/
+		size_t MergeFrom( ComponentManager& source, const std::vector<EntityId>& entities, std::vector<EntityId>& remap );
+
+		/*
+		*	Creates an owning group for the passed component types, keeping their ComponentMap vectors co-sorted
+		*	Calling this again with the same types returns the existing group
+		*	@return	Group:	The created group, returns nullptr if any of the types is already owned by a different group
+		*/
+		template<typename ... Owned>
+		Group<Owned ...>* CreateGroup()
+		{
+			static_assert( sizeof...( Owned ) > 0 && sizeof...( Owned ) <= MAX_GROUP_TYPES, "A group owns between 1 and MAX_GROUP_TYPES component types" );
+			( CanConvert_From<Owned, Component>(), ... );
+
+			const std::vector<uint64_t> types = { Owned::ID ... };
+
+			ComponentGroup* existing = nullptr;
+			for( uint64_t type : types )
+			{
+				auto it = m_groupOwners.find( type );
+				if( it != m_groupOwners.end() )
+				{
+					if( existing != nullptr && existing != it->second )
+					{
+						return nullptr;
+					}
+					existing = it->second;
+				}
+			}
+
+			if( existing != nullptr )
+			{
+				// Only the exact same set of types can share a group
+				return existing->GetTypes() == types ? static_cast<Group<Owned ...>*>( existing ) : nullptr;
+			}
+
+			Group<Owned ...>* group = new Group<Owned ...>( { &m_componentMap[Owned::ID] ... } );
+			m_groups.push_back( group );
+			for( uint64_t type : types )
+			{
+				m_groupOwners[type] = group;
+			}
+
+			SortIntoGroup( group );
+
+			return group;
+		}
+
+		/*
+		*	Runs the incremental compaction pass until the passed time budget is spent, continuing where the previous call stopped
+		*	Holes are closed in entities' component arrays, and component storage and system iteration order is re-sorted by EntityId
+		*	Work is done in units of a few entities, one component type or one system, a unit that has started always finishes
+		*	Must not be called while systems are updating
+		*	@param	float:	Seconds the pass may take
+		*	@return	bool:	Returns true, if a full pass was completed during this call
+		*/
+		bool Compact( float timeBudget );
+
+		// Adds the component counts and the memory of the component storage, per component type
+		void CollectStats( WorldStats& stats ) const;
+
+		// Returns the group owning exactly the passed component types, returning nullptr if there is none
+		template<typename ... Owned>
+		Group<Owned ...>* GetGroup()
+		{
+			const std::vector<uint64_t> types = { Owned::ID ... };
+
+			auto it = m_groupOwners.find( types[0] );
+			if( it == m_groupOwners.end() || it->second->GetTypes() != types )
+			{
+				return nullptr;
+			}
+			return static_cast<Group<Owned ...>*>( it->second );
+		}
+
 
 	private:
 
+		/*
+		*	Adds the passed component to the passed entity and to this component manager, without notifying systems
+		*	@param	Entity:		The entity that will own the component
+		*	@param	Component:	The component to add, capacity must have been checked by the caller
+		*/
+		void AttachComponent( Entity& entity, Component* component );
+
+		/*
+		*	Removes the passed component from the ComponentMap vector of its type, by swapping the last component into its place
+		*	If the component's type is owned by a group, the entity is moved out of the group first, keeping the group's prefix intact
+		*	@param	Entity:		The entity that owns the component
+		*	@param	Component:	The component to remove
+		*/
+		void RemoveFromComponentMap( const Entity& entity, Component* component );
+
+		// Removes the component from the component array, swapping the last component into its slot
+		void RemoveFromComponentArray( Component* component );
+
+		/*
+		*	Moves the entities that already match the passed group into its prefix
+		*/
+		void SortIntoGroup( ComponentGroup* group );
+
+		/*
+		*	Moves an entity's components to the front of its component array, systems stop reading an entity's components at the first hole
+		*	@return	bool:	Returns true, if any hole was closed
+		*/
+		bool CompactEntityComponents( Entity& entity );
+
 		/*
 		*	Removes all components from this component manager
 		*/
@@ -0,0 +1,238 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef COMPONENTOBSERVER_H
+#define COMPONENTOBSERVER_H
+
+#include "ECS_Definitions.h"
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace ECS
+{
+	using ComponentObserverId = uint32_t;
+
+	// Receives the entities affected since the last flush, sorted by EntityId
+	using ComponentObserverCallback = std::function<void( const std::vector<EntityId>& )>;
+
+	/*
+	*	Batched observers of component adds and removes, subscribed per component type
+	*	Changes are only recorded for types that have an observer, and each observer is called once per flush with every entity affected since the last flush
+	*	Batches hold the net change, from whether the entity had the type at the last flush and whether it has it now:
+	*	an entity that gained and lost the type between flushes is in neither batch, one that lost it and gained it again,
+	*	e.g. when its EntityId was handed to a new entity, is in both, as the component it had is gone
+	*/
+	class ComponentObservers
+	{
+		struct Subscription
+		{
+			uint64_t					m_componentType;
+
+			// True for OnAdded, false for OnRemoved
+			bool						m_bOnAdded;
+
+			bool						m_bActive;
+
+			ComponentObserverCallback	m_callback;
+		};
+
+		// A single add or remove of the observed type
+		struct Change
+		{
+			EntityId				m_entityId;
+
+			// True for an add, false for a remove
+			bool					m_bAdded;
+		};
+
+		// Changes recorded for a single observed component type
+		struct PendingChanges
+		{
+			// Adds and removes in the order they were made, both kinds are needed to tell the net change
+			std::vector<Change>		m_log;
+
+			// Number of active observers of each kind, nothing is recorded for a type without observers
+			uint32_t				m_addedObservers = 0;
+			uint32_t				m_removedObservers = 0;
+		};
+
+		// The subscriptions, indexed by ComponentObserverId
+		std::vector<Subscription>	m_subscriptions;
+
+		// Released ComponentObserverIds, ready to be reused
+		std::vector<ComponentObserverId>	m_freeSubscriptions;
+
+		// Recorded changes, keyed by component type
+		std::unordered_map<uint64_t, PendingChanges>	m_changes;
+
+		// Scratch log the recorded changes are swapped into while flushing
+		std::vector<Change>			m_log;
+
+		// Scratch batches handed to the callbacks
+		std::vector<EntityId>		m_added;
+		std::vector<EntityId>		m_removed;
+
+		// Scratch list of the component types with recorded changes
+		std::vector<uint64_t>		m_flushTypes;
+
+	public:
+
+		static constexpr ComponentObserverId INVALID_OBSERVER = 0xFFFFFFFF;
+
+		ComponentObservers() {}
+		~ComponentObservers() {}
+
+		ComponentObservers( const ComponentObservers& ) = delete;
+		ComponentObservers& operator=( const ComponentObservers& ) = delete;
+		ComponentObservers( ComponentObservers&& ) = delete;
+		ComponentObservers& operator=( ComponentObservers&& ) = delete;
+
+		ComponentObserverId Subscribe( uint64_t componentType, bool bOnAdded, ComponentObserverCallback callback )
+		{
+			ComponentObserverId observerId = INVALID_OBSERVER;
+			if( !m_freeSubscriptions.empty() )
+			{
+				observerId = m_freeSubscriptions.back();
+				m_freeSubscriptions.pop_back();
+			}
+			else
+			{
+				observerId = static_cast<ComponentObserverId>( m_subscriptions.size() );
+				m_subscriptions.emplace_back();
+			}
+
+			m_subscriptions[observerId] = { componentType, bOnAdded, true, std::move( callback ) };
+
+			PendingChanges& changes = m_changes[componentType];
+			++( bOnAdded ? changes.m_addedObservers : changes.m_removedObservers );
+
+			return observerId;
+		}
+
+		void Unsubscribe( ComponentObserverId observerId )
+		{
+			if( observerId >= m_subscriptions.size() || !m_subscriptions[observerId].m_bActive )
+			{
+				return;
+			}
+
+			Subscription& subscription = m_subscriptions[observerId];
+			subscription.m_bActive = false;
+			subscription.m_callback = nullptr;
+			m_freeSubscriptions.push_back( observerId );
+
+			PendingChanges& changes = m_changes[subscription.m_componentType];
+			--( subscription.m_bOnAdded ? changes.m_addedObservers : changes.m_removedObservers );
+			if( changes.m_addedObservers == 0 && changes.m_removedObservers == 0 )
+			{
+				changes.m_log.clear();
+			}
+		}
+
+		inline void RecordAdded( uint64_t componentType, EntityId entityId )
+		{
+			Record( componentType, entityId, true );
+		}
+
+		inline void RecordRemoved( uint64_t componentType, EntityId entityId )
+		{
+			Record( componentType, entityId, false );
+		}
+
+		/*
+		*	Calls every observer with its batch, changes made by the callbacks are recorded for the next flush
+		*	@param	HasComponent:	Callable taking ( EntityId, uint64_t componentType ), returning true if the entity currently has the type
+		*/
+		template<typename HasComponent>
+		void Flush( HasComponent&& hasComponent )
+		{
+			// Collected up front, a callback subscribing to a new type may grow m_changes
+			m_flushTypes.clear();
+			for( const auto& pair : m_changes )
+			{
+				if( !pair.second.m_log.empty() )
+				{
+					m_flushTypes.push_back( pair.first );
+				}
+			}
+
+			for( uint64_t componentType : m_flushTypes )
+			{
+				// Swapped out, so changes made by the callbacks go into the next batch
+				m_log.swap( m_changes[componentType].m_log );
+
+				// Grouped by entity, keeping the order of each entity's changes
+				std::stable_sort( m_log.begin(), m_log.end(), []( const Change& a, const Change& b ) { return a.m_entityId < b.m_entityId; } );
+
+				for( size_t first = 0, last = 0; first < m_log.size(); first = last )
+				{
+					const EntityId entityId = m_log[first].m_entityId;
+					while( last < m_log.size() && m_log[last].m_entityId == entityId )
+					{
+						++last;
+					}
+
+					// Starting with a remove means the entity had the type at the last flush, ending with an add means it has it now
+					if( !m_log[first].m_bAdded )
+					{
+						m_removed.push_back( entityId );
+					}
+					if( m_log[last - 1].m_bAdded && hasComponent( entityId, componentType ) )
+					{
+						m_added.push_back( entityId );
+					}
+				}
+
+				Deliver( componentType, false, m_removed );
+				Deliver( componentType, true, m_added );
+
+				m_log.clear();
+				m_added.clear();
+				m_removed.clear();
+			}
+		}
+
+	private:
+
+		inline void Record( uint64_t componentType, EntityId entityId, bool bAdded )
+		{
+			if( m_changes.empty() )
+			{
+				return;
+			}
+
+			auto it = m_changes.find( componentType );
+			if( it != m_changes.end() && ( it->second.m_addedObservers > 0 || it->second.m_removedObservers > 0 ) )
+			{
+				it->second.m_log.push_back( { entityId, bAdded } );
+			}
+		}
+
+		// Hands the batch to every observer of the passed type and kind
+		void Deliver( uint64_t componentType, bool bOnAdded, const std::vector<EntityId>& batch )
+		{
+			if( batch.empty() )
+			{
+				return;
+			}
+
+			// Indexed, as a callback may subscribe more observers
+			for( size_t i = 0; i < m_subscriptions.size(); ++i )
+			{
+				const Subscription& subscription = m_subscriptions[i];
+				if( subscription.m_bActive && subscription.m_bOnAdded == bOnAdded && subscription.m_componentType == componentType )
+				{
+					// Copied, the subscription may be released or moved by the callback
+					ComponentObserverCallback callback = subscription.m_callback;
+					callback( batch );
+				}
+			}
+		}
+
+	};
+
+}
+
+#endif // !COMPONENTOBSERVER_H
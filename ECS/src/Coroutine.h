@@ -0,0 +1,342 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+// Coroutines need C++20, without it this header is empty and ECS_COROUTINES is not defined
+#if defined( __cpp_impl_coroutine ) && __has_include( <coroutine> )
+
+#define ECS_COROUTINES 1
+
+#include "ECS_Definitions.h"
+#include "DynamicBuffer.h"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <vector>
+
+namespace ECS
+{
+	/*
+	*	Signaled by a job, usually from a worker thread, to resume the coroutines waiting on it with co_await WaitForJob( fence )
+	*/
+	class JobFence
+	{
+		std::atomic<bool>	m_bSignaled;
+
+	public:
+
+		JobFence() : m_bSignaled( false ) {}
+		~JobFence() {}
+
+		JobFence( const JobFence& ) = delete;
+		JobFence& operator=( const JobFence& ) = delete;
+		JobFence( JobFence&& ) = delete;
+		JobFence& operator=( JobFence&& ) = delete;
+
+		inline void Signal() { m_bSignaled.store( true, std::memory_order_release ); }
+
+		inline void Reset() { m_bSignaled.store( false, std::memory_order_relaxed ); }
+
+		inline bool IsSignaled() const { return m_bSignaled.load( std::memory_order_acquire ); }
+	};
+
+
+	// What a suspended coroutine is waiting on
+	enum class CoroutineWait : uint8_t
+	{
+		None,
+		NextFrame,
+		Seconds,
+		Job
+	};
+
+
+	/*
+	*	Return type of a coroutine run by the CoroutineScheduler, e.g.
+	*		Task Patrol( World* world, EntityId entity ) { while( true ) { ...; co_await Seconds( 2.0f ); } }
+	*	Coroutine frames are allocated from a pool, so starting many short coroutines does not hit the heap every time
+	*	Arguments are copied into the frame, but anything captured by reference, including a lambda's captures, must outlive the coroutine
+	*/
+	class Task
+	{
+	public:
+
+		struct promise_type
+		{
+			// What this coroutine is waiting on while suspended
+			CoroutineWait		m_wait				= CoroutineWait::None;
+
+			// Seconds left to wait for CoroutineWait::Seconds
+			float				m_secondsRemaining	= 0.0f;
+
+			// The fence waited on for CoroutineWait::Job
+			const JobFence*		m_fence				= nullptr;
+
+			// Set when the coroutine is stopped, it is destroyed the next time the scheduler ticks
+			bool				m_bStopped			= false;
+
+			Task get_return_object() { return Task( std::coroutine_handle<promise_type>::from_promise( *this ) ); }
+
+			std::suspend_always initial_suspend() noexcept { return {}; }
+
+			std::suspend_always final_suspend() noexcept { return {}; }
+
+			void return_void() {}
+
+			void unhandled_exception() { std::terminate(); }
+
+			static void* operator new( size_t size )
+			{
+				return BufferPool<std::max_align_t>::AllocateBlock( GetSizeClass( size ) );
+			}
+
+			static void operator delete( void* frame, size_t size )
+			{
+				BufferPool<std::max_align_t>::ReleaseBlock( static_cast<std::max_align_t*>( frame ), GetSizeClass( size ) );
+			}
+
+		private:
+
+			static inline size_t GetSizeClass( size_t size )
+			{
+				return BufferPool<std::max_align_t>::GetSizeClass( ( size + sizeof( std::max_align_t ) - 1 ) / sizeof( std::max_align_t ) );
+			}
+		};
+
+		using Handle = std::coroutine_handle<promise_type>;
+
+		Task() : m_handle( nullptr ) {}
+
+		explicit Task( Handle handle ) : m_handle( handle ) {}
+
+		Task( Task&& other ) noexcept : m_handle( other.m_handle )
+		{
+			other.m_handle = nullptr;
+		}
+
+		Task& operator=( Task&& other ) noexcept
+		{
+			if( this != &other )
+			{
+				if( m_handle )
+				{
+					m_handle.destroy();
+				}
+				m_handle = other.m_handle, other.m_handle = nullptr;
+			}
+			return *this;
+		}
+
+		// A task that was never started is destroyed with it
+		~Task()
+		{
+			if( m_handle )
+			{
+				m_handle.destroy();
+			}
+		}
+
+		Task( const Task& ) = delete;
+		Task& operator=( const Task& ) = delete;
+
+		// Gives up ownership of the coroutine, leaving this task empty
+		inline Handle Release()
+		{
+			Handle handle = m_handle;
+			m_handle = nullptr;
+			return handle;
+		}
+
+	private:
+
+		Handle	m_handle;
+	};
+
+
+	// co_await NextFrame() suspends the coroutine until the next time the scheduler ticks
+	struct NextFrame
+	{
+		bool await_ready() const noexcept { return false; }
+		void await_suspend( Task::Handle handle ) const noexcept { handle.promise().m_wait = CoroutineWait::NextFrame; }
+		void await_resume() const noexcept {}
+	};
+
+
+	// co_await Seconds( t ) suspends the coroutine until at least t seconds of delta time have passed
+	struct Seconds
+	{
+		float	m_seconds;
+
+		explicit Seconds( float seconds ) : m_seconds( seconds ) {}
+
+		bool await_ready() const noexcept { return m_seconds <= 0.0f; }
+		void await_suspend( Task::Handle handle ) const noexcept
+		{
+			handle.promise().m_wait = CoroutineWait::Seconds;
+			handle.promise().m_secondsRemaining = m_seconds;
+		}
+		void await_resume() const noexcept {}
+	};
+
+
+	// co_await WaitForJob( fence ) suspends the coroutine until the fence is signaled, it is resumed on the scheduler's thread
+	struct WaitForJob
+	{
+		const JobFence&	m_fence;
+
+		explicit WaitForJob( const JobFence& fence ) : m_fence( fence ) {}
+
+		bool await_ready() const noexcept { return m_fence.IsSignaled(); }
+		void await_suspend( Task::Handle handle ) const noexcept
+		{
+			handle.promise().m_wait = CoroutineWait::Job;
+			handle.promise().m_fence = &m_fence;
+		}
+		void await_resume() const noexcept {}
+	};
+
+
+	/*
+	*	Owns running coroutines and resumes the ones that are ready, once per tick
+	*	Coroutines can belong to an entity, so they are stopped along with it
+	*/
+	class CoroutineScheduler
+	{
+		struct Entry
+		{
+			Task::Handle	m_handle;
+
+			// The entity this coroutine belongs to, 0 for none
+			EntityId		m_owner;
+		};
+
+		// Suspended coroutines
+		std::vector<Entry>	m_coroutines;
+
+	public:
+
+		CoroutineScheduler() : m_coroutines() {}
+
+		~CoroutineScheduler()
+		{
+			Clear();
+		}
+
+		CoroutineScheduler( const CoroutineScheduler& ) = delete;
+		CoroutineScheduler& operator=( const CoroutineScheduler& ) = delete;
+		CoroutineScheduler( CoroutineScheduler&& ) = delete;
+		CoroutineScheduler& operator=( CoroutineScheduler&& ) = delete;
+
+		/*
+		*	Takes ownership of the task and runs it until its first suspension
+		*	@param	owner:	The entity the coroutine belongs to, 0 for none
+		*/
+		void Start( Task task, EntityId owner = 0 )
+		{
+			Task::Handle handle = task.Release();
+			if( !handle )
+			{
+				return;
+			}
+
+			handle.resume();
+			if( handle.done() )
+			{
+				handle.destroy();
+				return;
+			}
+
+			m_coroutines.push_back( { handle, owner } );
+		}
+
+		// Stops every coroutine belonging to the passed entity, they are destroyed on the next tick so a coroutine may stop itself
+		void Stop( EntityId owner )
+		{
+			if( owner == 0 )
+			{
+				return;
+			}
+
+			for( Entry& entry : m_coroutines )
+			{
+				if( entry.m_owner == owner )
+				{
+					entry.m_handle.promise().m_bStopped = true;
+				}
+			}
+		}
+
+		// Resumes every coroutine whose wait is over, then destroys finished and stopped coroutines
+		void Tick( float deltaTime )
+		{
+			// Coroutines started while ticking are appended, and first resumed on the next tick
+			const size_t count = m_coroutines.size();
+			for( size_t i = 0; i < count; ++i )
+			{
+				const Task::Handle handle = m_coroutines[i].m_handle;
+				Task::promise_type& promise = handle.promise();
+
+				if( promise.m_bStopped || !IsReady( promise, deltaTime ) )
+				{
+					continue;
+				}
+
+				promise.m_wait = CoroutineWait::None;
+				handle.resume();
+			}
+
+			size_t alive = 0;
+			for( size_t i = 0; i < m_coroutines.size(); ++i )
+			{
+				const Task::Handle handle = m_coroutines[i].m_handle;
+				if( handle.done() || handle.promise().m_bStopped )
+				{
+					handle.destroy();
+					continue;
+				}
+				m_coroutines[alive++] = m_coroutines[i];
+			}
+			m_coroutines.resize( alive );
+		}
+
+		// Destroys every coroutine
+		void Clear()
+		{
+			for( Entry& entry : m_coroutines )
+			{
+				entry.m_handle.destroy();
+			}
+			m_coroutines.clear();
+		}
+
+		// Number of suspended coroutines
+		inline size_t GetCount() const { return m_coroutines.size(); }
+
+	private:
+
+		static bool IsReady( Task::promise_type& promise, float deltaTime )
+		{
+			switch( promise.m_wait )
+			{
+			case CoroutineWait::Seconds:
+				promise.m_secondsRemaining -= deltaTime;
+				return promise.m_secondsRemaining <= 0.0f;
+
+			case CoroutineWait::Job:
+				return promise.m_fence == nullptr || promise.m_fence->IsSignaled();
+
+			default:
+				return true;
+			}
+		}
+
+	};
+
+}
+
+#endif // __cpp_impl_coroutine
+
+#endif // !COROUTINE_H
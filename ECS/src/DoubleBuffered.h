@@ -0,0 +1,90 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef DOUBLEBUFFERED_H
+#define DOUBLEBUFFERED_H
+
+#include "Component.h"
+
+#include <utility>
+
+namespace ECS
+{
+	/*
+	*	A component holding two copies of <T>, reads see the value from the end of the last frame and writes go to the next frame's copy
+	*	Systems reading other entities' state can then run at the same time as the systems writing it, without seeing half written values
+	*	The copies are swapped by the World at the end of each Update, only for components that were written
+	*	Register the derived type with World::RegisterDoubleBuffered, e.g.
+	*		struct Boid : public DoubleBuffered<BoidState> { static constexpr uint64_t ID = GENERATE_ID( "Boid" ); Boid() : DoubleBuffered( ID ) {} };
+	*	A component must only be written by one thread per frame
+	*/
+	template<typename T>
+	class DoubleBuffered : public Component
+	{
+		// The two copies, m_buffers[m_readIndex] is last frame's value
+		T			m_buffers[2];
+
+		// Index of the copy that is read this frame
+		uint8_t		m_readIndex;
+
+		// Set by the first Write of a frame, only written components are swapped
+		bool		m_bWritten;
+
+	public:
+
+		explicit DoubleBuffered( uint64_t componentType, const T& value = T() ) :
+			Component( componentType ),
+			m_buffers{ value, value },
+			m_readIndex( 0 ),
+			m_bWritten( false )
+		{}
+
+		virtual ~DoubleBuffered() {}
+
+		// Returns the value as of the end of the last frame, unaffected by writes made this frame
+		inline const T& Read() const
+		{
+			return m_buffers[m_readIndex];
+		}
+
+		// Returns the next frame's value for writing, the first write of a frame copies last frame's value in, so untouched fields carry over
+		inline T& Write()
+		{
+			if( !m_bWritten )
+			{
+				m_buffers[m_readIndex ^ 1] = m_buffers[m_readIndex];
+				m_bWritten = true;
+			}
+			return m_buffers[m_readIndex ^ 1];
+		}
+
+		// Returns the value written this frame, or last frame's value if it has not been written, only for the thread writing this component
+		inline const T& ReadLatest() const
+		{
+			return m_buffers[m_bWritten ? m_readIndex ^ 1 : m_readIndex];
+		}
+
+		inline bool IsWritten() const { return m_bWritten; }
+
+		// Makes this frame's writes visible to Read, called by the World at the end of the frame
+		inline void SwapBuffers()
+		{
+			if( m_bWritten )
+			{
+				m_readIndex ^= 1;
+				m_bWritten = false;
+			}
+		}
+
+		// Sets both copies, for initialization outside of a frame
+		inline void Reset( const T& value )
+		{
+			m_buffers[0] = value;
+			m_buffers[1] = value;
+			m_bWritten = false;
+		}
+
+	};
+
+}
+
+#endif // !DOUBLEBUFFERED_H
@@ -0,0 +1,340 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef DYNAMICBUFFER_H
+#define DYNAMICBUFFER_H
+
+#include "Component.h"
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace ECS
+{
+	/*
+	*	Pool of raw element blocks for the element type <T>, blocks are grouped by power of two capacity and reused once released
+	*	Each thread has its own pool, so no locking is needed, a block released on another thread is simply reused by that thread
+	*	Blocks allocated or released after the thread's pool was destroyed, e.g. by other thread_local objects at thread exit, bypass the pool
+	*/
+	template<typename T>
+	class BufferPool
+	{
+		static constexpr size_t NUM_SIZE_CLASSES = 32;
+
+		// Released blocks per size class, where a size class holds blocks of (1 << sizeClass) elements
+		std::vector<void*>	m_freeBlocks[NUM_SIZE_CLASSES];
+
+		// Set once the calling thread's pool has been destroyed, trivially destructible so it can still be read during thread exit
+		static inline bool& IsDestroyed()
+		{
+			static thread_local bool s_bDestroyed = false;
+			return s_bDestroyed;
+		}
+
+	public:
+
+		BufferPool() {}
+
+		~BufferPool()
+		{
+			for( std::vector<void*>& blocks : m_freeBlocks )
+			{
+				for( void* block : blocks )
+				{
+					::operator delete( block, std::align_val_t( alignof( T ) ) );
+				}
+				blocks.clear();
+			}
+			IsDestroyed() = true;
+		}
+
+		BufferPool( const BufferPool& ) = delete;
+		BufferPool& operator=( const BufferPool& ) = delete;
+		BufferPool( BufferPool&& ) = delete;
+		BufferPool& operator=( BufferPool&& ) = delete;
+
+		static BufferPool& Get()
+		{
+			static thread_local BufferPool pool;
+			return pool;
+		}
+
+		// Allocates a block of (1 << sizeClass) elements from the calling thread's pool, or straight from the heap once the pool was destroyed
+		static T* AllocateBlock( size_t sizeClass )
+		{
+			if( IsDestroyed() )
+			{
+				return static_cast<T*>( ::operator new( sizeof( T ) << sizeClass, std::align_val_t( alignof( T ) ) ) );
+			}
+			return Get().Allocate( sizeClass );
+		}
+
+		// Releases a block into the calling thread's pool, or straight to the heap once the pool was destroyed
+		static void ReleaseBlock( T* block, size_t sizeClass )
+		{
+			if( IsDestroyed() )
+			{
+				::operator delete( block, std::align_val_t( alignof( T ) ) );
+				return;
+			}
+			Get().Release( block, sizeClass );
+		}
+
+		// Returns the size class that can hold the passed number of elements
+		static inline size_t GetSizeClass( size_t capacity )
+		{
+			size_t sizeClass = 0;
+			while( ( size_t( 1 ) << sizeClass ) < capacity )
+			{
+				++sizeClass;
+			}
+			return sizeClass;
+		}
+
+		// Returns an uninitialized block of (1 << sizeClass) elements
+		T* Allocate( size_t sizeClass )
+		{
+			std::vector<void*>& blocks = m_freeBlocks[sizeClass];
+			if( !blocks.empty() )
+			{
+				void* block = blocks.back();
+				blocks.pop_back();
+				return static_cast<T*>( block );
+			}
+
+			return static_cast<T*>( ::operator new( sizeof( T ) << sizeClass, std::align_val_t( alignof( T ) ) ) );
+		}
+
+		// Returns a block to the pool, the elements must already have been destroyed
+		void Release( T* block, size_t sizeClass )
+		{
+			m_freeBlocks[sizeClass].push_back( block );
+		}
+
+		// Number of released blocks waiting to be reused
+		size_t GetFreeBlockCount() const
+		{
+			size_t count = 0;
+			for( const std::vector<void*>& blocks : m_freeBlocks )
+			{
+				count += blocks.size();
+			}
+			return count;
+		}
+
+		// Number of bytes held by released blocks
+		size_t GetFreeBytes() const
+		{
+			size_t bytes = 0;
+			for( size_t sizeClass = 0; sizeClass < NUM_SIZE_CLASSES; ++sizeClass )
+			{
+				bytes += m_freeBlocks[sizeClass].size() * ( sizeof( T ) << sizeClass );
+			}
+			return bytes;
+		}
+
+		// Frees every released block
+		void Trim()
+		{
+			for( std::vector<void*>& blocks : m_freeBlocks )
+			{
+				for( void* block : blocks )
+				{
+					::operator delete( block, std::align_val_t( alignof( T ) ) );
+				}
+				blocks.clear();
+				blocks.shrink_to_fit();
+			}
+		}
+	};
+
+
+	/*
+	*	A component holding a variable length list of <T>
+	*	The first N elements are stored inline inside of the component, past that the elements spill into a block from the BufferPool
+	*	Derive from it to give the buffer a component type, e.g.
+	*		struct Waypoints : public DynamicBuffer<Kobe::Vector3, 8> { static constexpr uint64_t ID = GENERATE_ID( "Waypoints" ); Waypoints() : DynamicBuffer( ID ) {} };
+	*/
+	template<typename T, size_t N>
+	class DynamicBuffer : public Component
+	{
+		static_assert( N > 0, "DynamicBuffer needs an inline capacity of at least one element" );
+
+		// Inline storage for the first N elements
+		alignas( T ) unsigned char	m_inline[N * sizeof( T )];
+
+		// Points at the inline storage, or at the pooled block once spilled
+		T*							m_data;
+
+		// Number of elements in this buffer
+		size_t						m_size;
+
+		// Number of elements that fit before the buffer has to grow
+		size_t						m_capacity;
+
+	public:
+
+		explicit DynamicBuffer( uint64_t componentType ) :
+			Component( componentType ),
+			m_data( reinterpret_cast<T*>( m_inline ) ),
+			m_size( 0 ),
+			m_capacity( N )
+		{}
+
+		DynamicBuffer( const DynamicBuffer& other ) :
+			Component( other.GetComponentType() ),
+			m_data( reinterpret_cast<T*>( m_inline ) ),
+			m_size( 0 ),
+			m_capacity( N )
+		{
+			Reserve( other.m_size );
+			for( const T& element : other )
+			{
+				Add( element );
+			}
+		}
+
+		virtual ~DynamicBuffer()
+		{
+			Clear();
+			ReleaseBlock();
+		}
+
+		inline T& operator[]( size_t index ) { return m_data[index]; }
+		inline const T& operator[]( size_t index ) const { return m_data[index]; }
+
+		inline T* begin() { return m_data; }
+		inline T* end() { return m_data + m_size; }
+		inline const T* begin() const { return m_data; }
+		inline const T* end() const { return m_data + m_size; }
+
+		inline size_t Size() const { return m_size; }
+		inline size_t Capacity() const { return m_capacity; }
+		inline bool IsEmpty() const { return m_size == 0; }
+
+		// Returns true, if the elements no longer fit inline and have spilled into a pooled block
+		inline bool IsSpilled() const { return m_capacity > N; }
+
+		// Constructs a new element at the end of this buffer, the arguments may refer to elements of this buffer
+		template<typename ... Args>
+		T& Add( Args&& ... args )
+		{
+			if( m_size == m_capacity )
+			{
+				// Growing moves the elements, so the new element is built before any argument referring to them is left dangling
+				T value( std::forward<Args>( args ) ... );
+				Reserve( m_capacity * 2 );
+
+				T* element = new ( m_data + m_size ) T( std::move( value ) );
+				++m_size;
+				return *element;
+			}
+
+			T* element = new ( m_data + m_size ) T( std::forward<Args>( args ) ... );
+			++m_size;
+			return *element;
+		}
+
+		// Removes the element at the passed index, keeping the order of the remaining elements
+		void RemoveAt( size_t index )
+		{
+			if( index >= m_size )
+			{
+				return;
+			}
+
+			for( size_t i = index; i + 1 < m_size; ++i )
+			{
+				m_data[i] = std::move( m_data[i + 1] );
+			}
+			m_data[--m_size].~T();
+		}
+
+		// Removes the element at the passed index, by moving the last element into its place
+		void RemoveAtSwapBack( size_t index )
+		{
+			if( index >= m_size )
+			{
+				return;
+			}
+
+			if( index != m_size - 1 )
+			{
+				m_data[index] = std::move( m_data[m_size - 1] );
+			}
+			m_data[--m_size].~T();
+		}
+
+		// Destroys all elements, the capacity is kept
+		void Clear()
+		{
+			for( size_t i = 0; i < m_size; ++i )
+			{
+				m_data[i].~T();
+			}
+			m_size = 0;
+		}
+
+		// Makes sure the buffer can hold the passed number of elements, without growing again
+		void Reserve( size_t capacity )
+		{
+			if( capacity <= m_capacity )
+			{
+				return;
+			}
+
+			const size_t sizeClass = BufferPool<T>::GetSizeClass( capacity );
+			T* block = BufferPool<T>::AllocateBlock( sizeClass );
+
+			for( size_t i = 0; i < m_size; ++i )
+			{
+				new ( block + i ) T( std::move( m_data[i] ) );
+				m_data[i].~T();
+			}
+
+			ReleaseBlock();
+
+			m_data = block;
+			m_capacity = size_t( 1 ) << sizeClass;
+		}
+
+		// Moves the elements back inline when they fit, returning the pooled block
+		void ShrinkToFit()
+		{
+			if( !IsSpilled() || m_size > N )
+			{
+				return;
+			}
+
+			T* inlineData = reinterpret_cast<T*>( m_inline );
+			for( size_t i = 0; i < m_size; ++i )
+			{
+				new ( inlineData + i ) T( std::move( m_data[i] ) );
+				m_data[i].~T();
+			}
+
+			ReleaseBlock();
+
+			m_data = inlineData;
+			m_capacity = N;
+		}
+
+	private:
+
+		// Returns the pooled block to the pool, if the buffer has spilled
+		void ReleaseBlock()
+		{
+			if( IsSpilled() )
+			{
+				BufferPool<T>::ReleaseBlock( m_data, BufferPool<T>::GetSizeClass( m_capacity ) );
+				m_data = reinterpret_cast<T*>( m_inline );
+				m_capacity = N;
+			}
+		}
+
+	};
+
+}
+
+#endif // !DYNAMICBUFFER_H
@@ -3,6 +3,7 @@
 #ifndef ECS_DEFINITIONS_H
 #define ECS_DEFINITIONS_H
 
+#include <bitset>
 #include <cstdint>
 
 #include "Utility/CompilerHash.h"
@@ -17,12 +18,27 @@ namespace ECS {
 
 	static constexpr size_t MAX_ENTITIES	{ 10000 };
 
+	// The largest EntityId that can be handed out, EntityId 0 is reserved for an invalid entity
+	static constexpr size_t MAX_ENTITY_ID	{ MAX_ENTITIES + 1 };
+
 	static constexpr size_t MAX_COMPONENTS_PER_ENTITY	{ 1000 };
 
 	static constexpr size_t MAX_SYSTEMS	{ 1000 };
 
 	static constexpr size_t MAX_COMPONENTS	{ MAX_ENTITIES * MAX_COMPONENTS_PER_ENTITY };
 
+	static constexpr size_t MAX_GROUP_TYPES	{ 16 };
+
+	static constexpr size_t MAX_TAGS	{ 128 };
+
+	// One bit per tag type, a tag only exists as its bit in an entity's tag signature
+	using TagSignature = std::bitset<MAX_TAGS>;
+
+	static constexpr size_t MAX_RESOURCES	{ 128 };
+
+	// One bit per resource type, used by systems to declare the resources they read and write
+	using ResourceSignature = std::bitset<MAX_RESOURCES>;
+
 }
 
 
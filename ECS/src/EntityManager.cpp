@@ -5,7 +5,12 @@
 namespace ECS
 {
 	EntityManager::EntityManager() :
-		m_entityCounter( 0 )
+		m_entityCounter( 0 ),
+		m_nextEntityId( 1 ),
+		m_freeEntityIds(),
+		m_entityTags( MAX_ENTITY_ID + 1 ),
+		m_entityEnabled( MAX_ENTITY_ID + 1, 1 ),
+		m_entityAlive( MAX_ENTITY_ID + 1, 0 )
 	{
 		for( int i = 0; i < MAX_ENTITIES; ++i )
 		{
@@ -19,51 +24,192 @@ namespace ECS
 		CleanUpEntities();
 	}
 
+	void EntityManager::CollectStats( WorldStats& stats ) const
+	{
+		stats.m_entityCount = m_entityCounter;
+		stats.m_entityCapacity = MAX_ENTITIES;
+		stats.m_highestEntityId = m_nextEntityId.load( std::memory_order_relaxed ) - 1;
+		stats.m_freeEntityIds = m_freeEntityIds.size();
+		stats.m_pooledEntities = m_entityPool.GetPooledCount();
+		stats.m_entitiesPendingCleanUp = m_entitiesMarkedForCleanUp.size();
+
+		const uint64_t entityObjects = m_entityCounter + stats.m_pooledEntities + stats.m_entitiesPendingCleanUp;
+		stats.m_entityBytes = entityObjects * sizeof( Entity )
+			+ m_entityTags.capacity() * sizeof( TagSignature )
+			+ m_entityEnabled.capacity() * sizeof( uint8_t )
+			+ m_entityAlive.capacity() * sizeof( uint8_t );
+	}
+
 	EntityId EntityManager::CreateEntity()
 	{
+		if( m_entityCounter >= MAX_ENTITIES )
+		{
+			return 0;
+		}
 
-		/* '>' check works for entity counter, because the 0 entity id is reserved for an invalid entity id, and an entity id is incremented as its assigned*/
-		if( m_entityCounter > MAX_ENTITIES )
+		// Reuse the EntityId of a destroyed entity first, so the EntityId space is not used up
+		EntityId entityId = 0;
+		if( !m_freeEntityIds.empty() )
+		{
+			entityId = m_freeEntityIds.back();
+			m_freeEntityIds.pop_back();
+		}
+		else if( ReserveEntityIds( 1, entityId ) == 0 )
 		{
 			return 0;
 		}
 
+		if( !CreateReservedEntity( entityId ) )
+		{
+			m_freeEntityIds.push_back( entityId );
+			return 0;
+		}
+
+		return entityId;
+	}
+
+	uint64_t EntityManager::ReserveEntityIds( uint64_t count, EntityId& first )
+	{
+		EntityId next = m_nextEntityId.load( std::memory_order_relaxed );
+		uint64_t reserved = 0;
+		do
+		{
+			if( next > MAX_ENTITY_ID )	// Every EntityId has been handed out
+			{
+				return 0;
+			}
+
+			reserved = count < MAX_ENTITY_ID + 1 - next ? count : MAX_ENTITY_ID + 1 - next;
+		}
+		while( !m_nextEntityId.compare_exchange_weak( next, next + reserved, std::memory_order_relaxed ) );
+
+		first = next;
+		return reserved;
+	}
+
+	bool EntityManager::CreateReservedEntity( EntityId entityId )
+	{
+		if( entityId == 0 || entityId > MAX_ENTITY_ID || m_entityCounter >= MAX_ENTITIES || Exists( entityId ) )
+		{
+			return false;
+		}
+
 		Entity* entity = GetNewEntity();
 
 		if( entity == nullptr )
 		{
-			return 0;
+			return false;
 		}
 
-		entity->m_entityId = ++m_entityCounter;
-		m_entities[m_entityCounter] = entity;
+		entity->m_entityId = entityId;
+		m_entities[entityId] = entity;
+		m_entityAlive[entityId] = 1;
+		++m_entityCounter;
 
-		return m_entityCounter;
+		return true;
+	}
+
+	uint64_t EntityManager::ReserveFreeEntityIds( uint64_t count, std::vector<EntityId>& out )
+	{
+		uint64_t reserved = 0;
+		while( reserved < count && !m_freeEntityIds.empty() )
+		{
+			out.push_back( m_freeEntityIds.back() );
+			m_freeEntityIds.pop_back();
+			++reserved;
+		}
 
+		if( reserved < count )
+		{
+			EntityId first = 0;
+			const uint64_t fresh = ReserveEntityIds( count - reserved, first );
+			for( uint64_t i = fresh; i > 0; --i )
+			{
+				out.push_back( first + i - 1 );
+			}
+			reserved += fresh;
+		}
+
+		return reserved;
+	}
+
+	void EntityManager::ReleaseReservedEntityIds( EntityId first, uint64_t count )
+	{
+		for( uint64_t i = 0; i < count; ++i )
+		{
+			m_freeEntityIds.push_back( first + i );
+		}
+	}
+
+	void EntityManager::ReleaseReservedEntityIds( const std::vector<EntityId>& entityIds )
+	{
+		m_freeEntityIds.insert( m_freeEntityIds.end(), entityIds.begin(), entityIds.end() );
 	}
 
 
 	bool EntityManager::MarkEntityForCleanUp( EntityId entityId )
 	{
-		Entity* entity = m_entities[entityId];
+		auto it = m_entities.find( entityId );
 
 		// Entity does not exist, returning
-		if( entity == nullptr )
+		if( it == m_entities.end() || it->second == nullptr )
 		{
 			return false;
 		}
 
-		m_entities.erase( entityId );
+		Entity* entity = it->second;
+		m_entities.erase( it );
 
 		MarkEntityForCleanUp( entity );
+		m_freeEntityIds.push_back( entityId );
 
 		--m_entityCounter;
 
 		return true;
 	}
 
+	bool EntityManager::SetTag( EntityId entityId, size_t tagIndex, bool bValue )
+	{
+		if( entityId > MAX_ENTITY_ID || tagIndex >= MAX_TAGS )
+		{
+			return false;
+		}
+
+		if( m_entityAlive[entityId] == 0 )	// Entity does not exist
+		{
+			return false;
+		}
+
+		m_entityTags[entityId].set( tagIndex, bValue );
+		return true;
+	}
+
+	bool EntityManager::SetEnabled( EntityId entityId, bool bEnabled )
+	{
+		if( entityId > MAX_ENTITY_ID )
+		{
+			return false;
+		}
+
+		if( m_entityAlive[entityId] == 0 )	// Entity does not exist
+		{
+			return false;
+		}
+
+		m_entityEnabled[entityId] = bEnabled ? 1 : 0;
+		return true;
+	}
+
 	void EntityManager::MarkEntityForCleanUp( Entity* entity )
 	{
+		if( entity->m_entityId <= MAX_ENTITY_ID )
+		{
+			// The EntityId will be handed out again, so it must not keep the tags or state of this entity
+			m_entityTags[entity->m_entityId].reset();
+			m_entityEnabled[entity->m_entityId] = 1;
+			m_entityAlive[entity->m_entityId] = 0;
+		}
+
 		entity->m_bMarkedForCleanUp = true;
 		entity->m_entityId = 0;
 		m_entitiesMarkedForCleanUp.push_back( entity );
@@ -71,18 +217,13 @@ namespace ECS
 
 	void EntityManager::MarkAllEntitiesForCleanUp()
 	{
-		Entity* entity = nullptr;
-		for( uint64_t i = 0; i < m_entityCounter; i++ )
+		// EntityIds are not contiguous once entities have been destroyed or ids reserved, so walk the map
+		for( auto& pair : m_entities )
 		{
-			entity = m_entities[i];
-
-			// Entity does not exist, returning
-			if( entity == nullptr )
+			if( pair.second != nullptr )
 			{
-				return;
+				MarkEntityForCleanUp( pair.second );
 			}
-
-			MarkEntityForCleanUp( entity );
 		}
 		m_entities.clear();
 		m_entityCounter = 0;
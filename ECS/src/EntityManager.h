@@ -4,8 +4,11 @@
 #define ENTITYMANAGER_H
 
 #include "Entity.h"
+#include "Tag.h"
+#include "WorldStats.h"
 #include "Utility/ObjectPool.h"
 
+#include <atomic>
 #include <map>
 #include <vector>
 
@@ -20,6 +23,7 @@ namespace ECS
 		friend struct Parser;
 
 		friend class ComponentManager;
+		friend class World;
 
 		// The entities created by this Entity Manager
 		std::map<EntityId, Entity*>    m_entities;
@@ -27,12 +31,27 @@ namespace ECS
 		// The number of entities in this entity manager
 		uint64_t				m_entityCounter;
 
+		// The next EntityId that has never been handed out, advanced atomically so ids can be reserved from any thread
+		std::atomic<EntityId>	m_nextEntityId;
+
+		// EntityIds of destroyed entities, ready to be handed out again
+		std::vector<EntityId>	m_freeEntityIds;
+
 		// Entities that have been removed from the 'm_entities' map and have been marked for clean up
 		std::vector<Entity*>	m_entitiesMarkedForCleanUp;
 
 		// Object pool used to manage the creation and deletion of entities
 		ObjectPool<Entity>		m_entityPool;
 
+		// The tag signature of each entity, indexed by EntityId
+		std::vector<TagSignature>	m_entityTags;
+
+		// Whether each entity is enabled, indexed by EntityId
+		std::vector<uint8_t>	m_entityEnabled;
+
+		// Whether an entity exists for each EntityId, so per-entity checks do not search 'm_entities'
+		std::vector<uint8_t>	m_entityAlive;
+
 	public:
 
 		EntityManager();
@@ -43,6 +62,44 @@ namespace ECS
 		*	@return	EntityId:	The EntityId of the created entity, if an Entity could not be created an EntityId of 0 will be returned
 		*/
 		EntityId CreateEntity();
+
+		/*
+		*	Reserves a range of EntityIds that have never been handed out, without locking, safe to call from any thread
+		*	The entities do not exist until CreateReservedEntity is called for them
+		*	@param	uint64_t:	The number of EntityIds wanted
+		*	@param	EntityId:	Filled with the first reserved EntityId
+		*	@return	uint64_t:	The number of EntityIds reserved, fewer than wanted once the EntityId space runs out
+		*/
+		uint64_t ReserveEntityIds( uint64_t count, EntityId& first );
+
+		/*
+		*	Creates the entity for an EntityId reserved with ReserveEntityIds, must be called from the thread owning the world
+		*	@return	bool:	Returns true, if the entity was created. Returns false, if the EntityId is invalid, already in use or the manager is full
+		*/
+		bool CreateReservedEntity( EntityId entityId );
+
+		/*
+		*	Reserves EntityIds, taking the EntityIds of destroyed entities first, must be called from the thread owning the world
+		*	The entities do not exist until CreateReservedEntity is called for them
+		*	@param	uint64_t:	The number of EntityIds wanted
+		*	@param	vector:		The reserved EntityIds are appended to it, the first one to use last
+		*	@return	uint64_t:	The number of EntityIds reserved, fewer than wanted once the EntityId space runs out
+		*/
+		uint64_t ReserveFreeEntityIds( uint64_t count, std::vector<EntityId>& out );
+
+		/*
+		*	Gives reserved EntityIds that will not be used back, so they can be handed out again, must be called from the thread owning the world
+		*/
+		void ReleaseReservedEntityIds( EntityId first, uint64_t count );
+
+		// Gives the passed reserved EntityIds back, must be called from the thread owning the world
+		void ReleaseReservedEntityIds( const std::vector<EntityId>& entityIds );
+
+		// Returns true, if an entity with the passed EntityId exists
+		inline bool Exists( EntityId entityId ) const
+		{
+			return entityId <= MAX_ENTITY_ID && m_entityAlive[entityId] != 0;
+		}
 		
 		/*
 		*	Marks the Entity with the identical EntityId that has been passed for clean up
@@ -51,6 +108,43 @@ namespace ECS
 		*/
 		bool MarkEntityForCleanUp( EntityId entityId );
 
+		/*
+		*	Sets or clears the passed tag bit on the entity with the passed EntityId, no allocation is made and no system is notified
+		*	@param	EntityId:	The EntityId of the entity to tag
+		*	@param	size_t:		The bit index of the tag, from GetTagIndex<T>()
+		*	@param	bool:		True to add the tag, false to remove it
+		*	@return	bool:	Returns true, if the entity exists and the tag index is valid. Returns false, if otherwise
+		*/
+		bool SetTag( EntityId entityId, size_t tagIndex, bool bValue );
+
+		// Returns true, if the entity with the passed EntityId has the passed tag bit set
+		inline bool HasTag( EntityId entityId, size_t tagIndex ) const
+		{
+			return entityId <= MAX_ENTITY_ID && tagIndex < MAX_TAGS && m_entityTags[entityId].test( tagIndex );
+		}
+
+		/*
+		*	Enables or disables the entity with the passed EntityId, disabled entities keep their components but are skipped when systems iterate
+		*	This is not a structural change, no allocation is made and no system is notified
+		*	@return	bool:	Returns true, if the entity exists. Returns false, if otherwise
+		*/
+		bool SetEnabled( EntityId entityId, bool bEnabled );
+
+		// Returns true, if the entity with the passed EntityId is enabled
+		inline bool IsEnabled( EntityId entityId ) const
+		{
+			return entityId <= MAX_ENTITY_ID && m_entityEnabled[entityId] != 0;
+		}
+
+		// Adds the entity counts and the memory taken by entities
+		void CollectStats( WorldStats& stats ) const;
+
+		// Returns the tag signature of the entity with the passed EntityId
+		inline const TagSignature& GetTags( EntityId entityId ) const
+		{
+			return m_entityTags[entityId <= MAX_ENTITY_ID ? entityId : 0];
+		}
+
 	private:
 
 		/*
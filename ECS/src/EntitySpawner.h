@@ -0,0 +1,175 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef ENTITYSPAWNER_H
+#define ENTITYSPAWNER_H
+
+#include "ECS_Definitions.h"
+#include "Component.h"
+#include "EntityManager.h"
+#include "Tag.h"
+#include "Utility/TemplateHelper.h"
+
+#include <utility>
+#include <vector>
+
+namespace ECS
+{
+	/*
+	*	Creates entities from a worker thread, e.g. inside of a procedural generation job
+	*	EntityIds are handed out immediately, from EntityIds the World gives each spawner at every sync point, destroyed entities' EntityIds first
+	*	A spawner that runs out before the next sync point reserves never used EntityIds from the EntityManager without locking,
+	*	which EntityIds it gets then depends on the timing of the other threads
+	*	The entities, their components and tags are materialized by World::MaterializeSpawnedEntities at the next sync point, until then systems do not see them
+	*	A spawner must only be used by one thread at a time, create one per job or worker thread with World::CreateSpawner
+	*/
+	class EntitySpawner
+	{
+		friend class World;
+
+		// An entity waiting to be materialized
+		struct PendingEntity
+		{
+			EntityId				m_entityId;
+
+			// Components created for the entity, owned by the spawner until materialized
+			std::vector<Component*>	m_components;
+
+			TagSignature			m_tags;
+		};
+
+		// The entity manager ids are reserved from
+		EntityManager*				m_entityManager;
+
+		// EntityIds reserved for this spawner, handed out from the back
+		std::vector<EntityId>		m_reservedIds;
+
+		// Entities created since the last materialization
+		std::vector<PendingEntity>	m_pending;
+
+	public:
+
+		// Number of EntityIds reserved at a time, and kept reserved by each spawner at every sync point
+		static constexpr uint64_t RANGE_SIZE = 64;
+
+		explicit EntitySpawner( EntityManager* entityManager ) :
+			m_entityManager( entityManager ),
+			m_reservedIds(),
+			m_pending()
+		{}
+
+		~EntitySpawner()
+		{
+			Discard();
+		}
+
+		EntitySpawner( const EntitySpawner& ) = delete;
+		EntitySpawner& operator=( const EntitySpawner& ) = delete;
+		EntitySpawner( EntitySpawner&& ) = delete;
+		EntitySpawner& operator=( EntitySpawner&& ) = delete;
+
+		/*
+		*	Creates an entity, its EntityId can be used right away, e.g. stored in components of other spawned entities
+		*	@return	EntityId:	The EntityId of the created entity, 0 if the EntityId space has run out
+		*/
+		EntityId CreateEntity()
+		{
+			if( m_reservedIds.empty() )
+			{
+				// Ran out before the sync point, the free EntityIds can only be taken there
+				EntityId first = 0;
+				const uint64_t reserved = m_entityManager->ReserveEntityIds( RANGE_SIZE, first );
+				if( reserved == 0 )
+				{
+					return 0;
+				}
+
+				for( uint64_t i = reserved; i > 0; --i )
+				{
+					m_reservedIds.push_back( first + i - 1 );
+				}
+			}
+
+			const EntityId entityId = m_reservedIds.back();
+			m_reservedIds.pop_back();
+			m_pending.push_back( { entityId, {}, {} } );
+			return entityId;
+		}
+
+		/*
+		*	Creates a component for an entity created by this spawner, the component is constructed now but attached at the next sync point
+		*	@param	<T>:		The type of Component that will be created
+		*	@param	EntityId:	An entity created by this spawner, that has not been materialized yet
+		*	@param	Args:		The constructor requirements for the component
+		*	@return	T*:			The created component, nullptr if the entity is not pending on this spawner or is at capacity
+		*/
+		template<typename T, typename ... Args>
+		T* AddComponent( EntityId entityId, Args&& ... args )
+		{
+			// Complile-time check to see if class T can be converted to class B,
+				// valid for derivation check of class T from class B
+			CanConvert_From<T, Component>();
+
+			PendingEntity* entity = FindPending( entityId );
+			if( entity == nullptr || entity->m_components.size() >= MAX_COMPONENTS_PER_ENTITY )
+			{
+				return nullptr;
+			}
+
+			ComponentSizes::Record<T>();
+
+			T* component = new T( std::forward<Args>( args ) ... );
+			entity->m_components.push_back( component );
+			return component;
+		}
+
+		// Adds the tag <T> to an entity created by this spawner, that has not been materialized yet
+		template<typename T>
+		bool AddTag( EntityId entityId )
+		{
+			PendingEntity* entity = FindPending( entityId );
+			const size_t index = GetTagIndex<T>();
+			if( entity == nullptr || index >= MAX_TAGS )
+			{
+				return false;
+			}
+
+			entity->m_tags.set( index );
+			return true;
+		}
+
+		// Number of entities waiting to be materialized
+		inline size_t GetPendingCount() const { return m_pending.size(); }
+
+	private:
+
+		// Returns the pending entity with the passed EntityId, recently created entities are found first
+		PendingEntity* FindPending( EntityId entityId )
+		{
+			for( size_t i = m_pending.size(); i > 0; --i )
+			{
+				if( m_pending[i - 1].m_entityId == entityId )
+				{
+					return &m_pending[i - 1];
+				}
+			}
+			return nullptr;
+		}
+
+		// Deletes the pending entities' components
+		void Discard()
+		{
+			for( PendingEntity& entity : m_pending )
+			{
+				for( Component* component : entity.m_components )
+				{
+					delete component, component = nullptr;
+				}
+			}
+			m_pending.clear();
+		}
+
+	};
+
+}
+
+#endif // !ENTITYSPAWNER_H
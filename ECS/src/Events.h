@@ -0,0 +1,271 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include "ECS_Definitions.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ECS
+{
+	// Used to give each event type a dense index into the World's event channels
+	struct EventFamily {};
+
+	// Interface used by the World to own and swap event channels of any type
+	class IEventChannel
+	{
+	public:
+		IEventChannel() {}
+		virtual ~IEventChannel() {}
+
+		// Makes the events sent since the last swap readable, and recycles the storage of the events read since then
+		virtual void Swap() = 0;
+
+		// Drops every pending and readable event, keeping the storage
+		virtual void Clear() = 0;
+
+		// Number of events readable this frame
+		virtual size_t GetCount() const = 0;
+	};
+
+	namespace EventsDetail
+	{
+		// Hands out an id per channel that is never reused, so per-thread caches can not mistake a new channel for a destroyed one
+		inline uint64_t NextChannelId()
+		{
+			static std::atomic<uint64_t> s_nextId { 1 };
+			return s_nextId.fetch_add( 1, std::memory_order_relaxed );
+		}
+	}
+
+	/*
+	*	A typed queue of transient events, e.g. Events<CollisionEvent>, used instead of adding and removing marker components
+	*	Send can be called from any thread, each thread appends to its own buffer so writers never contend
+	*	Events sent during a frame are readable in bulk for the whole next frame, the World swaps the channels at the start of each Update
+	*	Storage is kept between frames, once the buffers have grown to the peak event count, sending does not allocate
+	*	Events are only kept while the channel has at least one subscriber, Send is a no-op otherwise
+	*	Events of one thread are read in the order they were sent, there is no ordering between threads
+	*/
+	template<typename T>
+	class Events : public IEventChannel
+	{
+		// The events of a single sending thread
+		struct WriterBuffer
+		{
+			// Events sent this frame
+			std::vector<T>	m_writing;
+
+			// Events sent last frame, read this frame
+			std::vector<T>	m_readable;
+
+			// The thread sending into this buffer
+			std::thread::id	m_owner;
+		};
+
+		// One buffer per thread that has sent events, owned by this channel
+		std::vector<WriterBuffer*>	m_buffers;
+
+		// Guards m_buffers, only taken when a thread's buffer is not in its cache
+		std::mutex					m_buffersMutex;
+
+		// The buffers with events readable this frame, only changed by Swap, so reads do not race with new threads sending
+		std::vector<const WriterBuffer*>	m_readableBuffers;
+
+		// Keys the per-thread buffer caches
+		const uint64_t				m_channelId;
+
+		// Number of subscribers, events sent while it is 0 are dropped
+		std::atomic<uint32_t>		m_subscribers;
+
+		// Number of events readable this frame, over all buffers
+		size_t						m_readableCount;
+
+	public:
+
+		Events() :
+			m_buffers(),
+			m_buffersMutex(),
+			m_readableBuffers(),
+			m_channelId( EventsDetail::NextChannelId() ),
+			m_subscribers( 0 ),
+			m_readableCount( 0 )
+		{}
+
+		virtual ~Events()
+		{
+			for( WriterBuffer* buffer : m_buffers )
+			{
+				delete buffer, buffer = nullptr;
+			}
+			m_buffers.clear();
+			m_readableBuffers.clear();
+		}
+
+		Events( const Events& ) = delete;
+		Events& operator=( const Events& ) = delete;
+		Events( Events&& ) = delete;
+		Events& operator=( Events&& ) = delete;
+
+		// Queues the event for the next frame, safe to call from any thread while systems are updating
+		inline void Send( const T& event )
+		{
+			if( HasSubscribers() )
+			{
+				GetWriterBuffer().m_writing.push_back( event );
+			}
+		}
+
+		// Constructs the event in place and queues it for the next frame, safe to call from any thread while systems are updating
+		template<typename ... Args>
+		inline void Emplace( Args&& ... args )
+		{
+			if( HasSubscribers() )
+			{
+				GetWriterBuffer().m_writing.emplace_back( std::forward<Args>( args ) ... );
+			}
+		}
+
+		// Adds a subscriber, events sent from now on are kept until the frame after they were sent
+		inline void Subscribe()
+		{
+			m_subscribers.fetch_add( 1, std::memory_order_relaxed );
+		}
+
+		inline void Unsubscribe()
+		{
+			m_subscribers.fetch_sub( 1, std::memory_order_relaxed );
+		}
+
+		inline bool HasSubscribers() const
+		{
+			return m_subscribers.load( std::memory_order_relaxed ) > 0;
+		}
+
+		/*
+		*	Calls function( const T& ) for every event sent last frame
+		*	Any number of threads can read at the same time, the events stay readable until the next swap
+		*/
+		template<typename Function>
+		void ForEach( Function&& function ) const
+		{
+			for( const WriterBuffer* buffer : m_readableBuffers )
+			{
+				for( const T& event : buffer->m_readable )
+				{
+					function( event );
+				}
+			}
+		}
+
+		// Appends every event sent last frame to the passed vector
+		void CopyTo( std::vector<T>& out ) const
+		{
+			out.reserve( out.size() + m_readableCount );
+			for( const WriterBuffer* buffer : m_readableBuffers )
+			{
+				out.insert( out.end(), buffer->m_readable.begin(), buffer->m_readable.end() );
+			}
+		}
+
+		inline bool IsEmpty() const { return m_readableCount == 0; }
+
+		virtual size_t GetCount() const override { return m_readableCount; }
+
+		// Called by the World at the start of each Update, must not be called while events are being sent or read
+		virtual void Swap() override
+		{
+			std::lock_guard<std::mutex> lock( m_buffersMutex );
+
+			m_readableCount = 0;
+			m_readableBuffers.clear();
+			for( WriterBuffer* buffer : m_buffers )
+			{
+				// The events read last frame are cleared, keeping their storage for this frame's writes
+				std::swap( buffer->m_writing, buffer->m_readable );
+				buffer->m_writing.clear();
+
+				if( !buffer->m_readable.empty() )
+				{
+					m_readableCount += buffer->m_readable.size();
+					m_readableBuffers.push_back( buffer );
+				}
+			}
+		}
+
+		// Called by the World when it rolls back, the events sent in the rewound frames never happened
+		virtual void Clear() override
+		{
+			std::lock_guard<std::mutex> lock( m_buffersMutex );
+
+			for( WriterBuffer* buffer : m_buffers )
+			{
+				buffer->m_writing.clear();
+				buffer->m_readable.clear();
+			}
+			m_readableBuffers.clear();
+			m_readableCount = 0;
+		}
+
+	private:
+
+		// Returns the calling thread's buffer, creating it the first time the thread sends to this channel
+		WriterBuffer& GetWriterBuffer()
+		{
+			// Channels this thread has sent to, most recently added last
+			static thread_local std::vector<std::pair<uint64_t, WriterBuffer*>> t_buffers;
+
+			for( auto it = t_buffers.rbegin(); it != t_buffers.rend(); ++it )
+			{
+				if( it->first == m_channelId )
+				{
+					return *it->second;
+				}
+			}
+
+			const std::thread::id threadId = std::this_thread::get_id();
+
+			WriterBuffer* buffer = nullptr;
+			{
+				std::lock_guard<std::mutex> lock( m_buffersMutex );
+
+				// The entry may have been dropped from the cache, each thread only ever has one buffer per channel
+				for( WriterBuffer* existing : m_buffers )
+				{
+					if( existing->m_owner == threadId )
+					{
+						buffer = existing;
+						break;
+					}
+				}
+
+				if( buffer == nullptr )
+				{
+					buffer = new WriterBuffer();
+					buffer->m_owner = threadId;
+					m_buffers.push_back( buffer );
+				}
+			}
+
+			// Entries of destroyed channels are never matched again, dropping the oldest entry only costs a lookup in m_buffers
+			if( t_buffers.size() >= MAX_CACHED_CHANNELS )
+			{
+				t_buffers.erase( t_buffers.begin() );
+			}
+			t_buffers.emplace_back( m_channelId, buffer );
+
+			return *buffer;
+		}
+
+		// Channels of type <T> whose buffer each thread remembers
+		static constexpr size_t MAX_CACHED_CHANNELS { 8 };
+
+	};
+
+}
+
+#endif // !EVENTS_H
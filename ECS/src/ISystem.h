@@ -3,8 +3,23 @@
 #ifndef ISYSTEM_H
 #define ISYSTEM_H
 
+#include "ECS_Definitions.h"
+#include "Resource.h"
+#include "WorldStats.h"
+
+#include <vector>
+
 namespace ECS {
 
+	// How often the SystemManager updates a system
+	enum class UpdatePolicy : uint8_t
+	{
+		EveryFrame,		// Updated once per frame, with the frame's delta time
+		FixedRate,		// Updated at most once per interval, with the time elapsed since its last update
+		FixedTimestep,	// Updated zero or more times per frame with a constant step, left over time is carried into the next frame
+		TimeSliced		// Updated every frame, processing one of N slices of its entities, with the time elapsed since that slice was last processed
+	};
+
 	class ISystem
 	{
 		ISystem(const ISystem&) = delete;
@@ -23,15 +38,122 @@ namespace ECS {
 		// The world this system exists in
 		class World*			m_world;
 
+		// The resources this system has declared it reads
+		ResourceSignature		m_resourceReads;
+
+		// The resources this system has declared it writes
+		ResourceSignature		m_resourceWrites;
+
+		// How often the SystemManager updates this system
+		UpdatePolicy			m_updatePolicy;
+
+		// Seconds between updates for FixedRate, or the step for FixedTimestep
+		float					m_updateInterval;
+
+		// Time not yet consumed by FixedRate or FixedTimestep updates
+		float					m_timeAccumulator;
+
+		// The most FixedTimestep updates run in a single frame, past that the backlog is dropped
+		uint32_t				m_maxStepsPerFrame;
+
+		// Number of slices for TimeSliced
+		uint32_t				m_sliceCount;
+
+		// The slice processed by the current TimeSliced update
+		uint32_t				m_currentSlice;
+
+		// Time since each slice was last processed, for TimeSliced
+		std::vector<float>		m_sliceElapsed;
+
+		// Time since the last update, for FixedRate
+		float					m_timeSinceUpdate;
+
 	public:
 
-		explicit ISystem(uint64_t systemID) : m_systemManagerId(0), m_systemId(systemID), m_world(nullptr) {}
+		explicit ISystem(uint64_t systemID) : 
+			m_systemManagerId(0), 
+			m_systemId(systemID), 
+			m_world(nullptr), 
+			m_resourceReads(), 
+			m_resourceWrites(),
+			m_updatePolicy(UpdatePolicy::EveryFrame),
+			m_updateInterval(0.0f),
+			m_timeAccumulator(0.0f),
+			m_maxStepsPerFrame(1),
+			m_sliceCount(1),
+			m_currentSlice(0),
+			m_sliceElapsed(),
+			m_timeSinceUpdate(0.0f)
+		{}
 		virtual ~ISystem() {}
 
 		virtual void Update(float deltaTime) = 0;
 
 		virtual void OnEntitySignatureChanged( const struct Entity& entity ) = 0;
 
+		// Fills in the passed statistics, systems with matched entities report their count and storage
+		virtual void CollectStats( SystemStats& stats ) const
+		{
+			stats.m_systemId = m_systemId;
+		}
+
+		inline const ResourceSignature& GetResourceReads() const { return m_resourceReads; }
+
+		inline const ResourceSignature& GetResourceWrites() const { return m_resourceWrites; }
+
+		// Returns true, if this system and the passed system cannot run at the same time, because one writes a resource the other uses
+		inline bool HasResourceConflict( const ISystem& other ) const
+		{
+			return ( m_resourceWrites & ( other.m_resourceReads | other.m_resourceWrites ) ).any()
+				|| ( other.m_resourceWrites & m_resourceReads ).any();
+		}
+
+		// Updates this system once per frame, this is the default
+		void SetUpdateEveryFrame()
+		{
+			SetUpdatePolicy( UpdatePolicy::EveryFrame, 0.0f, 1, 1 );
+		}
+
+		/*
+		*	Updates this system at most the passed number of times per second, e.g. 10 for AI
+		*	@param	updatesPerSecond:	Must be greater than 0
+		*/
+		void SetFixedRate( float updatesPerSecond )
+		{
+			SetUpdatePolicy( UpdatePolicy::FixedRate, 1.0f / updatesPerSecond, 1, 1 );
+		}
+
+		/*
+		*	Updates this system with a constant step, as many times as the frame's delta time allows, e.g. for physics
+		*	@param	step:				Seconds per update, must be greater than 0
+		*	@param	maxStepsPerFrame:	Caps the updates per frame, so a slow frame can not cause ever more updates
+		*/
+		void SetFixedTimestep( float step, uint32_t maxStepsPerFrame = 8 )
+		{
+			SetUpdatePolicy( UpdatePolicy::FixedTimestep, step, maxStepsPerFrame > 0 ? maxStepsPerFrame : 1, 1 );
+		}
+
+		/*
+		*	Updates this system every frame, with the system only processing one of the passed number of slices of its entities
+		*	@param	sliceCount:		Number of frames it takes to process every entity once
+		*/
+		void SetTimeSliced( uint32_t sliceCount )
+		{
+			SetUpdatePolicy( UpdatePolicy::TimeSliced, 0.0f, 1, sliceCount > 0 ? sliceCount : 1 );
+		}
+
+		inline UpdatePolicy GetUpdatePolicy() const { return m_updatePolicy; }
+
+		// Returns how far the FixedTimestep accumulator is into the next step, in [0, 1), used to interpolate between steps
+		inline float GetFixedTimestepAlpha() const
+		{
+			return m_updatePolicy == UpdatePolicy::FixedTimestep ? m_timeAccumulator / m_updateInterval : 0.0f;
+		}
+
+		inline uint32_t GetSliceCount() const { return m_sliceCount; }
+
+		inline uint32_t GetCurrentSlice() const { return m_currentSlice; }
+
 	protected:
 
 		inline World* GetWorld() const
@@ -39,6 +161,111 @@ namespace ECS {
 			return m_world;
 		};
 
+		// Declares that this system reads the resource <T>
+		template<typename T>
+		void DeclareResourceRead()
+		{
+			const size_t index = GetResourceIndex<T>();
+			if( index < MAX_RESOURCES )
+			{
+				m_resourceReads.set( index );
+			}
+		}
+
+		// Declares that this system writes the resource <T>, writing implies reading
+		template<typename T>
+		void DeclareResourceWrite()
+		{
+			const size_t index = GetResourceIndex<T>();
+			if( index < MAX_RESOURCES )
+			{
+				m_resourceReads.set( index );
+				m_resourceWrites.set( index );
+			}
+		}
+
+	private:
+
+		void SetUpdatePolicy( UpdatePolicy policy, float interval, uint32_t maxStepsPerFrame, uint32_t sliceCount )
+		{
+			m_updatePolicy = policy;
+			m_updateInterval = interval;
+			m_timeAccumulator = 0.0f;
+			m_maxStepsPerFrame = maxStepsPerFrame;
+			m_sliceCount = sliceCount;
+			m_currentSlice = 0;
+			m_sliceElapsed.assign( sliceCount, 0.0f );
+			m_timeSinceUpdate = 0.0f;
+		}
+
+		// Advances this system by the frame's delta time, calling Update as its update policy allows
+		void Tick( float deltaTime )
+		{
+			switch( m_updatePolicy )
+			{
+			case UpdatePolicy::EveryFrame:
+				Update( deltaTime );
+				break;
+
+			case UpdatePolicy::FixedRate:
+			{
+				m_timeAccumulator += deltaTime;
+				m_timeSinceUpdate += deltaTime;
+				if( m_timeAccumulator >= m_updateInterval )
+				{
+					// Keep the time past the interval so the average rate matches the requested rate
+					m_timeAccumulator -= m_updateInterval;
+					if( m_timeAccumulator >= m_updateInterval )	// Fell behind, only a single update is run per frame
+					{
+						m_timeAccumulator = 0.0f;
+					}
+
+					const float elapsed = m_timeSinceUpdate;
+					m_timeSinceUpdate = 0.0f;
+					Update( elapsed );
+				}
+				break;
+			}
+
+			case UpdatePolicy::FixedTimestep:
+			{
+				m_timeAccumulator += deltaTime;
+
+				uint32_t steps = 0;
+				while( m_timeAccumulator >= m_updateInterval && steps < m_maxStepsPerFrame )
+				{
+					m_timeAccumulator -= m_updateInterval;
+					++steps;
+					Update( m_updateInterval );
+				}
+
+				if( m_timeAccumulator >= m_updateInterval )	// Fell behind, drop the backlog rather than spiral
+				{
+					m_timeAccumulator = 0.0f;
+				}
+				break;
+			}
+
+			case UpdatePolicy::TimeSliced:
+			{
+				for( float& elapsed : m_sliceElapsed )
+				{
+					elapsed += deltaTime;
+				}
+
+				const float elapsed = m_sliceElapsed[m_currentSlice];
+				m_sliceElapsed[m_currentSlice] = 0.0f;
+				Update( elapsed );
+
+				m_currentSlice = ( m_currentSlice + 1 ) % m_sliceCount;
+				break;
+			}
+			}
+		}
+
+		// Orders the matched entities by EntityId, called by the ComponentManager's compaction pass
+		virtual void SortMatchedEntities() {}
+
 	};
 	
 }
@@ -0,0 +1,192 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#include "Interest.h"
+#include "World.h"
+
+#include <algorithm>
+
+namespace ECS
+{
+
+	void InterestSystem::Update( float /*deltaTime*/ )
+	{
+		SpatialGridSystem* gridSystem = GetWorld()->GetSystem<SpatialGridSystem>();
+		if( gridSystem == nullptr )
+		{
+			return;
+		}
+
+		const SpatialHashGrid& grid = gridSystem->GetGrid();
+		for( Observer& observer : m_observers )
+		{
+			if( observer.m_bActive )
+			{
+				UpdateObserver( observer, grid );
+			}
+		}
+	}
+
+	ObserverId InterestSystem::AddObserver( const Kobe::Vector3& position, float radius )
+	{
+		const ObserverId observerId = CreateObserver();
+
+		Observer& observer = m_observers[observerId];
+		observer.m_position = position;
+		observer.m_radius = radius;
+
+		return observerId;
+	}
+
+	ObserverId InterestSystem::AddEntityObserver( EntityId entityId, float radius )
+	{
+		const ObserverId observerId = CreateObserver();
+
+		Observer& observer = m_observers[observerId];
+		observer.m_radius = radius;
+		observer.m_followEntity = entityId;
+
+		return observerId;
+	}
+
+	void InterestSystem::RemoveObserver( ObserverId observerId )
+	{
+		if( !IsObserverValid( observerId ) )
+		{
+			return;
+		}
+
+		Observer& observer = m_observers[observerId];
+		observer.m_bActive = false;
+		observer.m_visible.clear();
+		observer.m_entered.clear();
+		observer.m_left.clear();
+		m_freeObservers.push_back( observerId );
+	}
+
+	void InterestSystem::SetObserverPosition( ObserverId observerId, const Kobe::Vector3& position )
+	{
+		if( IsObserverValid( observerId ) )
+		{
+			m_observers[observerId].m_position = position;
+			m_observers[observerId].m_bDetached = false;
+		}
+	}
+
+	void InterestSystem::SetObserverRadius( ObserverId observerId, float radius )
+	{
+		if( IsObserverValid( observerId ) )
+		{
+			m_observers[observerId].m_radius = radius;
+		}
+	}
+
+	bool InterestSystem::IsVisible( ObserverId observerId, EntityId entityId ) const
+	{
+		if( !IsObserverValid( observerId ) )
+		{
+			return false;
+		}
+
+		const std::vector<EntityId>& visible = m_observers[observerId].m_visible;
+		return std::binary_search( visible.begin(), visible.end(), entityId );
+	}
+
+	ObserverId InterestSystem::CreateObserver()
+	{
+		ObserverId observerId = INVALID_OBSERVER;
+		if( !m_freeObservers.empty() )
+		{
+			observerId = m_freeObservers.back();
+			m_freeObservers.pop_back();
+		}
+		else
+		{
+			observerId = static_cast<ObserverId>( m_observers.size() );
+			m_observers.emplace_back();
+		}
+
+		Observer& observer = m_observers[observerId];
+		observer.m_position = Kobe::Vector3();
+		observer.m_radius = 0.0f;
+		observer.m_followEntity = 0;
+		observer.m_bFollowFound = false;
+		observer.m_bDetached = false;
+		observer.m_bActive = true;
+
+		return observerId;
+	}
+
+	void InterestSystem::UpdateObserver( Observer& observer, const SpatialHashGrid& grid )
+	{
+		observer.m_entered.clear();
+		observer.m_left.clear();
+
+		if( observer.m_followEntity != 0 )
+		{
+			if( grid.Contains( observer.m_followEntity ) )
+			{
+				observer.m_position = grid.GetPosition( observer.m_followEntity );
+				observer.m_bFollowFound = true;
+			}
+			else if( observer.m_bFollowFound )
+			{
+				// The followed entity was destroyed, its EntityId may be handed to another entity, so it is not followed again
+				observer.m_followEntity = 0;
+				observer.m_bFollowFound = false;
+				observer.m_bDetached = true;
+			}
+		}
+
+		if( observer.m_bDetached )
+		{
+			observer.m_left.swap( observer.m_visible );
+			observer.m_visible.clear();
+			return;
+		}
+
+		// Query out to the leave radius, entities between the two radii only stay if they were already visible
+		m_candidates.clear();
+		grid.QueryRadius( observer.m_position, observer.m_radius * m_leaveRadiusScale, m_candidates );
+		std::sort( m_candidates.begin(), m_candidates.end() );
+
+		const float enterRadiusSquared = observer.m_radius * observer.m_radius;
+		const Kobe::Vector3& center = observer.m_position;
+
+		// Merge walk of the previous and the candidate sets, both sorted by EntityId
+		m_nextVisible.clear();
+		const std::vector<EntityId>& visible = observer.m_visible;
+		size_t v = 0;
+		for( EntityId entityId : m_candidates )
+		{
+			while( v < visible.size() && visible[v] < entityId )
+			{
+				observer.m_left.push_back( visible[v++] );
+			}
+
+			if( v < visible.size() && visible[v] == entityId )	// Still visible
+			{
+				m_nextVisible.push_back( entityId );
+				++v;
+				continue;
+			}
+
+			const Kobe::Vector3& position = grid.GetPosition( entityId );
+			const float dx = position.x - center.x;
+			const float dy = position.y - center.y;
+			const float dz = position.z - center.z;
+			if( dx * dx + dy * dy + dz * dz <= enterRadiusSquared )
+			{
+				m_nextVisible.push_back( entityId );
+				observer.m_entered.push_back( entityId );
+			}
+		}
+
+		while( v < visible.size() )
+		{
+			observer.m_left.push_back( visible[v++] );
+		}
+
+		observer.m_visible.swap( m_nextVisible );
+	}
+
+}
@@ -0,0 +1,145 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef INTEREST_H
+#define INTEREST_H
+
+#include "ECS_Definitions.h"
+#include "Entity.h"
+#include "ISystem.h"
+#include "SpatialGrid.h"
+
+#include "../../Math/include/Vector.h"
+
+#include <vector>
+
+namespace ECS
+{
+	using ObserverId = uint32_t;
+
+	/*
+	*	Maintains, for each observer, the set of entities inside of its area of interest, e.g. for each connected client
+	*	Each update only queries the SpatialGridSystem around each observer, so the cost follows the entities near observers, not the whole world
+	*	The entities entering and leaving each observer's area during the last update are kept, to feed replication or tooling
+	*	Register it after the SpatialGridSystem, a fixed rate update policy is usually enough
+	*/
+	class InterestSystem : public ISystem
+	{
+		struct Observer
+		{
+			// Center of the area of interest, unless the observer follows an entity
+			Kobe::Vector3			m_position;
+
+			// Entities within this radius enter the area of interest
+			float					m_radius;
+
+			// The entity whose position the area follows, 0 for none
+			EntityId				m_followEntity;
+
+			// Set once the followed entity has been found in the grid, losing it afterwards means it was destroyed
+			bool					m_bFollowFound;
+
+			// Set once the followed entity was lost, the observer sees nothing until it is given a position again
+			bool					m_bDetached;
+
+			// Entities in the area of interest, sorted by EntityId
+			std::vector<EntityId>	m_visible;
+
+			// Entities that entered and left during the last update, sorted by EntityId
+			std::vector<EntityId>	m_entered;
+			std::vector<EntityId>	m_left;
+
+			bool					m_bActive;
+		};
+
+		// The observers, indexed by ObserverId
+		std::vector<Observer>		m_observers;
+
+		// Released ObserverIds, ready to be reused
+		std::vector<ObserverId>		m_freeObservers;
+
+		// Entities stay visible until they are past radius * m_leaveRadiusScale, so entities near the edge do not flicker in and out
+		float						m_leaveRadiusScale;
+
+		// Scratch buffers reused by each update
+		std::vector<EntityId>		m_candidates;
+		std::vector<EntityId>		m_nextVisible;
+
+		// Returned for invalid observers
+		static inline const std::vector<EntityId>	s_noEntities {};
+
+	public:
+
+		static constexpr uint64_t ID = GENERATE_ID( "InterestSystem" );
+
+		static constexpr ObserverId INVALID_OBSERVER = 0xFFFFFFFF;
+
+		/*
+		*	@param	leaveRadiusScale:	How far past its radius an entity has to move before it leaves an area of interest, 1 for no hysteresis
+		*/
+		explicit InterestSystem( float leaveRadiusScale = 1.1f ) :
+			ISystem( ID ),
+			m_observers(),
+			m_freeObservers(),
+			m_leaveRadiusScale( leaveRadiusScale < 1.0f ? 1.0f : leaveRadiusScale )
+		{}
+
+		virtual ~InterestSystem() {}
+
+		virtual void Update( float deltaTime ) override;
+
+		virtual void OnEntitySignatureChanged( const Entity& /*entity*/ ) override {}
+
+		// Adds an observer with a fixed area of interest, move it with SetObserverPosition
+		ObserverId AddObserver( const Kobe::Vector3& position, float radius );
+
+		/*
+		*	Adds an observer whose area of interest follows the position of the passed entity in the spatial grid
+		*	Once the entity is destroyed, or loses its Transform, everything visible leaves and the observer stops following it,
+		*	it sees nothing until it is moved with SetObserverPosition
+		*/
+		ObserverId AddEntityObserver( EntityId entityId, float radius );
+
+		void RemoveObserver( ObserverId observerId );
+
+		void SetObserverPosition( ObserverId observerId, const Kobe::Vector3& position );
+
+		void SetObserverRadius( ObserverId observerId, float radius );
+
+		// Returns true, if the entity was in the observer's area of interest after the last update
+		bool IsVisible( ObserverId observerId, EntityId entityId ) const;
+
+		// Entities in the observer's area of interest, sorted by EntityId, empty for an invalid observer
+		inline const std::vector<EntityId>& GetVisible( ObserverId observerId ) const
+		{
+			return IsObserverValid( observerId ) ? m_observers[observerId].m_visible : s_noEntities;
+		}
+
+		// Entities that entered the observer's area of interest during the last update, sorted by EntityId, empty for an invalid observer
+		inline const std::vector<EntityId>& GetEntered( ObserverId observerId ) const
+		{
+			return IsObserverValid( observerId ) ? m_observers[observerId].m_entered : s_noEntities;
+		}
+
+		// Entities that left the observer's area of interest during the last update, including destroyed entities, sorted by EntityId, empty for an invalid observer
+		inline const std::vector<EntityId>& GetLeft( ObserverId observerId ) const
+		{
+			return IsObserverValid( observerId ) ? m_observers[observerId].m_left : s_noEntities;
+		}
+
+		inline bool IsObserverValid( ObserverId observerId ) const
+		{
+			return observerId < m_observers.size() && m_observers[observerId].m_bActive;
+		}
+
+	private:
+
+		ObserverId CreateObserver();
+
+		// Recomputes the observer's area of interest from the grid, filling its enter and leave lists
+		void UpdateObserver( Observer& observer, const SpatialHashGrid& grid );
+
+	};
+
+}
+
+#endif // !INTEREST_H
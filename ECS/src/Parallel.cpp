@@ -0,0 +1,126 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#include "Parallel.h"
+
+namespace ECS
+{
+	namespace
+	{
+		// Set while a thread runs a job, nested Runs then stay on that thread
+		thread_local bool t_bInsideJob = false;
+	}
+
+	ParallelExecutor::ParallelExecutor( uint32_t workerCount ) :
+		m_threads(),
+		m_job( nullptr ),
+		m_context( nullptr ),
+		m_jobCount( 0 ),
+		m_nextJob( 0 ),
+		m_busyWorkers( 0 ),
+		m_generation( 0 ),
+		m_bShutdown( false )
+	{
+		for( uint32_t i = 0; i < workerCount; ++i )
+		{
+			m_threads.emplace_back( &ParallelExecutor::WorkerLoop, this );
+		}
+	}
+
+	ParallelExecutor::~ParallelExecutor()
+	{
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_bShutdown = true;
+		}
+		m_workStart.notify_all();
+
+		for( std::thread& thread : m_threads )
+		{
+			thread.join();
+		}
+		m_threads.clear();
+	}
+
+	void ParallelExecutor::RunJobs( size_t jobCount, JobFunction job, void* context )
+	{
+		if( jobCount == 0 )
+		{
+			return;
+		}
+
+		// Nothing to share the work with
+		if( t_bInsideJob || m_threads.empty() || jobCount == 1 )
+		{
+			const bool bWasInsideJob = t_bInsideJob;
+			t_bInsideJob = true;
+			for( size_t i = 0; i < jobCount; ++i )
+			{
+				job( context, i );
+			}
+			t_bInsideJob = bWasInsideJob;
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_job = job;
+			m_context = context;
+			m_jobCount = jobCount;
+			m_nextJob.store( 0, std::memory_order_relaxed );
+			m_busyWorkers = static_cast<uint32_t>( m_threads.size() );
+			++m_generation;
+		}
+		m_workStart.notify_all();
+
+		RunAvailableJobs( job, context, jobCount );
+
+		std::unique_lock<std::mutex> lock( m_mutex );
+		m_workDone.wait( lock, [this]() { return m_busyWorkers == 0; } );
+		m_job = nullptr;
+		m_context = nullptr;
+	}
+
+	void ParallelExecutor::RunAvailableJobs( JobFunction job, void* context, size_t jobCount )
+	{
+		t_bInsideJob = true;
+		for( size_t i = m_nextJob.fetch_add( 1, std::memory_order_relaxed ); i < jobCount; i = m_nextJob.fetch_add( 1, std::memory_order_relaxed ) )
+		{
+			job( context, i );
+		}
+		t_bInsideJob = false;
+	}
+
+	void ParallelExecutor::WorkerLoop()
+	{
+		uint64_t generation = 0;
+		while( true )
+		{
+			JobFunction job = nullptr;
+			void* context = nullptr;
+			size_t jobCount = 0;
+			{
+				std::unique_lock<std::mutex> lock( m_mutex );
+				m_workStart.wait( lock, [this, generation]() { return m_bShutdown || m_generation != generation; } );
+				if( m_bShutdown )
+				{
+					return;
+				}
+				generation = m_generation;
+				job = m_job;
+				context = m_context;
+				jobCount = m_jobCount;
+			}
+
+			RunAvailableJobs( job, context, jobCount );
+
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				if( --m_busyWorkers == 0 )
+				{
+					m_workDone.notify_one();
+				}
+			}
+		}
+	}
+
+}
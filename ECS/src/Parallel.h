@@ -0,0 +1,92 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "ECS_Definitions.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ECS
+{
+	// Entities per chunk in deterministic mode, chunk boundaries then only depend on the number of entities
+	static constexpr size_t DETERMINISTIC_CHUNK_SIZE { 256 };
+
+	/*
+	*	A fixed set of worker threads that run the jobs of a parallel loop, together with the calling thread
+	*	Jobs are handed out through a shared counter, so which thread runs a job is not fixed, results must only depend on the job index
+	*/
+	class ParallelExecutor
+	{
+		// Calls the job of the current Run for a single job index
+		using JobFunction = void( * )( void* context, size_t jobIndex );
+
+		std::vector<std::thread>	m_threads;
+
+		std::mutex					m_mutex;
+		std::condition_variable		m_workStart;
+		std::condition_variable		m_workDone;
+
+		// The job of the current Run, and its context
+		JobFunction					m_job;
+		void*						m_context;
+
+		size_t						m_jobCount;
+
+		// The next job index to hand out
+		std::atomic<size_t>			m_nextJob;
+
+		// Worker threads still working on the current Run
+		uint32_t					m_busyWorkers;
+
+		// Incremented to start a Run on the worker threads
+		uint64_t					m_generation;
+
+		bool						m_bShutdown;
+
+	public:
+
+		/*
+		*	@param	workerCount:	Number of threads created, the thread calling Run also runs jobs
+		*/
+		explicit ParallelExecutor( uint32_t workerCount );
+		~ParallelExecutor();
+
+		ParallelExecutor( const ParallelExecutor& ) = delete;
+		ParallelExecutor& operator=( const ParallelExecutor& ) = delete;
+		ParallelExecutor( ParallelExecutor&& ) = delete;
+		ParallelExecutor& operator=( ParallelExecutor&& ) = delete;
+
+		/*
+		*	Calls job( i ) for every i in [0, jobCount), returning once every job has finished
+		*	A Run started from inside of a job runs all of its jobs on the calling thread
+		*	@param	Function:	Callable taking ( size_t jobIndex )
+		*/
+		template<typename Function>
+		void Run( size_t jobCount, Function&& job )
+		{
+			RunJobs( jobCount, []( void* context, size_t jobIndex ) { ( *static_cast<std::remove_reference_t<Function>*>( context ) )( jobIndex ); }, &job );
+		}
+
+		// Number of threads running jobs, the workers and the calling thread
+		inline uint32_t GetThreadCount() const { return static_cast<uint32_t>( m_threads.size() ) + 1; }
+
+	private:
+
+		void RunJobs( size_t jobCount, JobFunction job, void* context );
+
+		// Runs jobs until every job index has been handed out
+		void RunAvailableJobs( JobFunction job, void* context, size_t jobCount );
+
+		void WorkerLoop();
+
+	};
+
+}
+
+#endif // !PARALLEL_H
@@ -25,11 +25,13 @@ namespace ECS
 				return;
 			}
 
-			uint64_t entityCount = world->m_enityManager->m_entityCounter;
-
-			for ( int i = 1; i <= entityCount; i++ )
+			// EntityIds are not contiguous once entities have been destroyed or ids reserved, so walk the map
+			for ( const auto& pair : world->m_enityManager->m_entities )
 			{
-				SearchEntity( *world->m_enityManager->m_entities[i] );
+				if ( pair.second != nullptr )
+				{
+					SearchEntity( *pair.second );
+				}
 			}
 		}
 
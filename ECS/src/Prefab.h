@@ -0,0 +1,161 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef PREFAB_H
+#define PREFAB_H
+
+#include "ECS_Definitions.h"
+#include "Component.h"
+#include "Reflection.h"
+#include "Tag.h"
+#include "Utility/TemplateHelper.h"
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ECS
+{
+	/*
+	*	Interface for a component stored inside of a Prefab
+	*/
+	class IPrefabComponent
+	{
+	public:
+		IPrefabComponent() {}
+		virtual ~IPrefabComponent() {}
+
+		// Creates a new component with the same values as this prefab component
+		virtual Component* Clone() const = 0;
+
+		virtual uint64_t GetComponentType() const = 0;
+	};
+
+
+	/*
+	*	Prefab component of type <T>
+	*	When <T> is copy constructible, the prototype is copied, so every instance starts with the prototype's current values
+	*	Otherwise, each instance is constructed from the arguments the prefab component was created with,
+	*	and when <T> is reflected with ECS_REFLECT, the prototype's reflected fields are then copied onto it
+	*/
+	template<typename T, typename ... Args>
+	class PrefabComponent : public IPrefabComponent
+	{
+		// The arguments used to construct each instance
+		std::tuple<std::decay_t<Args> ...>	m_arguments;
+
+		// The prototype instance, the values of this component are given to each instance
+		T									m_prototype;
+
+	public:
+
+		// Whether edits made to the prototype reach the instances
+		static constexpr bool IS_EDITABLE = std::is_copy_constructible_v<T> || Reflection<T>::IS_REFLECTED;
+
+		explicit PrefabComponent( Args&& ... args ) :
+			m_arguments( args ... ),
+			m_prototype( std::forward<Args>( args ) ... )
+		{
+			ComponentSizes::Record<T>();
+		}
+
+		virtual ~PrefabComponent() {}
+
+		virtual Component* Clone() const override
+		{
+			if constexpr( std::is_copy_constructible_v<T> )
+			{
+				return new T( m_prototype );
+			}
+			else
+			{
+				T* component = std::apply( []( const auto& ... args ) { return new T( args ... ); }, m_arguments );
+				if constexpr( Reflection<T>::IS_REFLECTED )
+				{
+					CopyComponentFields( Reflection<T>::Get(), m_prototype, *component );
+				}
+				return component;
+			}
+		}
+
+		virtual uint64_t GetComponentType() const override { return T::ID; }
+
+		inline std::conditional_t<IS_EDITABLE, T&, const T&> GetPrototype() { return m_prototype; }
+	};
+
+
+	/*
+	*	A Prefab is a template entity, holding a set of components and tags that can be instantiated many times in one call
+	*	Prefabs are not entities, they are never seen by systems
+	*/
+	class Prefab
+	{
+		friend class ComponentManager;
+
+		// The components given to each instance
+		std::vector<IPrefabComponent*>	m_components;
+
+		// The tags given to each instance
+		TagSignature					m_tags;
+
+	public:
+
+		Prefab() : m_components(), m_tags() {}
+
+		~Prefab()
+		{
+			for( IPrefabComponent* component : m_components )
+			{
+				delete component, component = nullptr;
+			}
+			m_components.clear();
+		}
+
+		Prefab( const Prefab& ) = delete;
+		Prefab& operator=( const Prefab& ) = delete;
+		Prefab( Prefab&& ) = delete;
+		Prefab& operator=( Prefab&& ) = delete;
+
+		/*
+		*	Adds a component of type <T> to this prefab, returning the prototype
+		*	The prototype can only be edited when <T> is copy constructible or reflected, otherwise it is returned const,
+		*	as each instance is constructed from the passed arguments and would not see the edits
+		*	For a reflected type that is not copy constructible, only edits to its reflected fields reach the instances
+		*	@param	Args:		The constructor requirements for the component
+		*/
+		template<typename T, typename ... Args>
+		std::conditional_t<PrefabComponent<T, Args ...>::IS_EDITABLE, T*, const T*> AddComponent( Args&& ... args )
+		{
+			// Complile-time check to see if class T can be converted to class B,
+				// valid for derivation check of class T from class B
+			CanConvert_From<T, Component>();
+
+			if( m_components.size() >= MAX_COMPONENTS_PER_ENTITY )
+			{
+				return nullptr;
+			}
+
+			PrefabComponent<T, Args ...>* component = new PrefabComponent<T, Args ...>( std::forward<Args>( args ) ... );
+			m_components.push_back( component );
+			return &component->GetPrototype();
+		}
+
+		// Adds the tag <T> to this prefab
+		template<typename T>
+		void AddTag()
+		{
+			const size_t index = GetTagIndex<T>();
+			if( index < MAX_TAGS )
+			{
+				m_tags.set( index );
+			}
+		}
+
+		inline size_t GetComponentCount() const { return m_components.size(); }
+
+		inline const TagSignature& GetTags() const { return m_tags; }
+	};
+
+}
+
+#endif // !PREFAB_H
@@ -0,0 +1,329 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#include "Reflection.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace ECS
+{
+	namespace
+	{
+		// Slots of the registry's open addressing table, kept at most half full
+		static constexpr size_t REGISTRY_SLOTS { MAX_REFLECTED_TYPES * 2 };
+
+		struct RegistrySlot
+		{
+			// The component type id, 0 while the slot is empty, written once
+			std::atomic<uint64_t>			m_componentType;
+
+			std::atomic<const TypeInfo*>	m_typeInfo;
+		};
+
+		// Zero initialized before any dynamic initialization, so types can register during static initialization of any translation unit
+		RegistrySlot s_registrySlots[REGISTRY_SLOTS];
+
+		// Number of occupied slots, only used by Register
+		size_t s_registeredTypes = 0;
+
+		// Only taken by Register, so two new types never claim the same slot
+		std::mutex& GetRegistryMutex()
+		{
+			static std::mutex mutex;
+			return mutex;
+		}
+
+		inline size_t GetRegistrySlot( uint64_t componentType )
+		{
+			return static_cast<size_t>( componentType ^ ( componentType >> 32 ) ) & ( REGISTRY_SLOTS - 1 );
+		}
+
+		// Returns the start of the reflected type, which the field offsets are relative to
+		inline const uint8_t* GetBytes( const TypeInfo& info, const Component& component )
+		{
+			return reinterpret_cast<const uint8_t*>( &component ) - info.m_componentOffset;
+		}
+
+		inline uint8_t* GetBytes( const TypeInfo& info, Component& component )
+		{
+			return reinterpret_cast<uint8_t*>( &component ) - info.m_componentOffset;
+		}
+
+		// Writes the fields in the passed mask, all of them for a full write
+		void WriteFields( const TypeInfo& info, const Component& component, uint64_t mask, std::vector<uint8_t>& out )
+		{
+			const uint8_t* bytes = GetBytes( info, component );
+
+			if( info.m_bTriviallyCopyable && mask == ~0ull )
+			{
+				// Runs of adjacent fields are copied with a single memcpy each
+				for( const FieldRun& run : info.m_runs )
+				{
+					out.insert( out.end(), bytes + run.m_offset, bytes + run.m_offset + run.m_size );
+				}
+				return;
+			}
+
+			for( size_t i = 0; i < info.m_fields.size(); ++i )
+			{
+				if( mask & ( 1ull << i ) )
+				{
+					const FieldInfo& field = info.m_fields[i];
+					if( field.m_bTriviallyCopyable )
+					{
+						out.insert( out.end(), bytes + field.m_offset, bytes + field.m_offset + field.m_size );
+					}
+					else
+					{
+						field.m_write( bytes + field.m_offset, out );
+					}
+				}
+			}
+		}
+
+		bool ReadFields( const TypeInfo& info, Component& component, uint64_t mask, const uint8_t*& in, const uint8_t* end )
+		{
+			uint8_t* bytes = GetBytes( info, component );
+
+			if( info.m_bTriviallyCopyable && mask == ~0ull )
+			{
+				for( const FieldRun& run : info.m_runs )
+				{
+					if( static_cast<size_t>( end - in ) < run.m_size )
+					{
+						return false;
+					}
+					std::memcpy( bytes + run.m_offset, in, run.m_size );
+					in += run.m_size;
+				}
+				return true;
+			}
+
+			for( size_t i = 0; i < info.m_fields.size(); ++i )
+			{
+				if( mask & ( 1ull << i ) )
+				{
+					const FieldInfo& field = info.m_fields[i];
+					if( field.m_bTriviallyCopyable )
+					{
+						if( static_cast<size_t>( end - in ) < field.m_size )
+						{
+							return false;
+						}
+						std::memcpy( bytes + field.m_offset, in, field.m_size );
+						in += field.m_size;
+					}
+					else if( !field.m_read( bytes + field.m_offset, in, end ) )
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+	}
+
+	bool TypeRegistry::Register( const TypeInfo* typeInfo )
+	{
+		const uint64_t componentType = typeInfo->m_componentType;
+		if( componentType == 0 )	// Reserved for empty slots
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock( GetRegistryMutex() );
+
+		size_t slot = GetRegistrySlot( componentType );
+		for( size_t probe = 0; probe < MAX_REFLECTED_TYPES; ++probe, slot = ( slot + 1 ) & ( REGISTRY_SLOTS - 1 ) )
+		{
+			RegistrySlot& entry = s_registrySlots[slot];
+			const uint64_t slotType = entry.m_componentType.load( std::memory_order_relaxed );
+			if( slotType == componentType )
+			{
+				entry.m_typeInfo.store( typeInfo, std::memory_order_release );
+				return true;
+			}
+
+			if( slotType == 0 )
+			{
+				if( s_registeredTypes >= MAX_REFLECTED_TYPES )
+				{
+					return false;
+				}
+				++s_registeredTypes;
+
+				// The TypeInfo is in place before readers can match the component type
+				entry.m_typeInfo.store( typeInfo, std::memory_order_relaxed );
+				entry.m_componentType.store( componentType, std::memory_order_release );
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const TypeInfo* TypeRegistry::Find( uint64_t componentType )
+	{
+		if( componentType == 0 )
+		{
+			return nullptr;
+		}
+
+		size_t slot = GetRegistrySlot( componentType );
+		for( size_t probe = 0; probe < MAX_REFLECTED_TYPES; ++probe, slot = ( slot + 1 ) & ( REGISTRY_SLOTS - 1 ) )
+		{
+			const RegistrySlot& entry = s_registrySlots[slot];
+			const uint64_t slotType = entry.m_componentType.load( std::memory_order_acquire );
+			if( slotType == componentType )
+			{
+				return entry.m_typeInfo.load( std::memory_order_acquire );
+			}
+
+			if( slotType == 0 )	// Types are never removed, so the first empty slot ends the probe
+			{
+				return nullptr;
+			}
+		}
+		return nullptr;
+	}
+
+	std::vector<const TypeInfo*> TypeRegistry::GetTypes()
+	{
+		std::vector<const TypeInfo*> types;
+		for( const RegistrySlot& entry : s_registrySlots )
+		{
+			if( entry.m_componentType.load( std::memory_order_acquire ) != 0 )
+			{
+				types.push_back( entry.m_typeInfo.load( std::memory_order_acquire ) );
+			}
+		}
+
+		std::sort( types.begin(), types.end(), []( const TypeInfo* a, const TypeInfo* b ) { return a->m_componentType < b->m_componentType; } );
+		return types;
+	}
+
+	bool SerializeComponent( const Component& component, std::vector<uint8_t>& out )
+	{
+		const TypeInfo* info = TypeRegistry::Find( component.GetComponentType() );
+		if( info == nullptr )
+		{
+			return false;
+		}
+
+		WriteFields( *info, component, ~0ull, out );
+		return true;
+	}
+
+	void SerializeComponent( const TypeInfo& info, const Component& component, std::vector<uint8_t>& out )
+	{
+		WriteFields( info, component, ~0ull, out );
+	}
+
+	bool DeserializeComponent( Component& component, const uint8_t*& in, const uint8_t* end )
+	{
+		const TypeInfo* info = TypeRegistry::Find( component.GetComponentType() );
+		return info != nullptr && ReadFields( *info, component, ~0ull, in, end );
+	}
+
+	bool DeserializeComponent( const TypeInfo& info, Component& component, const uint8_t*& in, const uint8_t* end )
+	{
+		return ReadFields( info, component, ~0ull, in, end );
+	}
+
+	uint64_t DiffComponents( const Component& a, const Component& b )
+	{
+		if( a.GetComponentType() != b.GetComponentType() )
+		{
+			return 0;
+		}
+
+		const TypeInfo* info = TypeRegistry::Find( a.GetComponentType() );
+		return info != nullptr ? DiffComponents( *info, a, b ) : 0;
+	}
+
+	uint64_t DiffComponents( const TypeInfo& info, const Component& a, const Component& b )
+	{
+		const uint8_t* bytesA = GetBytes( info, a );
+		const uint8_t* bytesB = GetBytes( info, b );
+
+		uint64_t mask = 0;
+		for( size_t i = 0; i < info.m_fields.size(); ++i )
+		{
+			const FieldInfo& field = info.m_fields[i];
+			const bool bEqual = field.m_bTriviallyCopyable
+				? std::memcmp( bytesA + field.m_offset, bytesB + field.m_offset, field.m_size ) == 0
+				: field.m_equals( bytesA + field.m_offset, bytesB + field.m_offset );
+
+			if( !bEqual )
+			{
+				mask |= 1ull << i;
+			}
+		}
+		return mask;
+	}
+
+	uint64_t SerializeComponentDelta( const Component& current, const Component& baseline, std::vector<uint8_t>& out )
+	{
+		const TypeInfo* info = TypeRegistry::Find( current.GetComponentType() );
+		if( info == nullptr || baseline.GetComponentType() != current.GetComponentType() )
+		{
+			return 0;
+		}
+
+		return SerializeComponentDelta( *info, current, baseline, out );
+	}
+
+	uint64_t SerializeComponentDelta( const TypeInfo& info, const Component& current, const Component& baseline, std::vector<uint8_t>& out )
+	{
+		const uint64_t mask = DiffComponents( info, current, baseline );
+		FieldSerializer<uint64_t>::Write( mask, out );
+
+		WriteFields( info, current, mask, out );
+		return mask;
+	}
+
+	void CopyComponentFields( const TypeInfo& info, const Component& from, Component& to )
+	{
+		const uint8_t* fromBytes = GetBytes( info, from );
+		uint8_t* toBytes = GetBytes( info, to );
+
+		if( info.m_bTriviallyCopyable )
+		{
+			for( const FieldRun& run : info.m_runs )
+			{
+				std::memcpy( toBytes + run.m_offset, fromBytes + run.m_offset, run.m_size );
+			}
+			return;
+		}
+
+		for( const FieldInfo& field : info.m_fields )
+		{
+			if( field.m_bTriviallyCopyable )
+			{
+				std::memcpy( toBytes + field.m_offset, fromBytes + field.m_offset, field.m_size );
+			}
+			else
+			{
+				field.m_copy( fromBytes + field.m_offset, toBytes + field.m_offset );
+			}
+		}
+	}
+
+	bool ApplyComponentDelta( Component& component, const uint8_t*& in, const uint8_t* end )
+	{
+		const TypeInfo* info = TypeRegistry::Find( component.GetComponentType() );
+		return info != nullptr && ApplyComponentDelta( *info, component, in, end );
+	}
+
+	bool ApplyComponentDelta( const TypeInfo& info, Component& component, const uint8_t*& in, const uint8_t* end )
+	{
+		uint64_t mask = 0;
+		if( !FieldSerializer<uint64_t>::Read( mask, in, end ) )
+		{
+			return false;
+		}
+
+		return ReadFields( info, component, mask, in, end );
+	}
+
+}
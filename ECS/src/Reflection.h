@@ -0,0 +1,394 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef REFLECTION_H
+#define REFLECTION_H
+
+#include "ECS_Definitions.h"
+#include "Component.h"
+#include "Utility/TemplateHelper.h"
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ECS
+{
+	// Most fields a reflected type can have, changed fields are tracked as a 64 bit mask
+	static constexpr size_t MAX_REFLECTED_FIELDS { 64 };
+
+	// Most component types the TypeRegistry can hold
+	static constexpr size_t MAX_REFLECTED_TYPES { 1024 };
+
+	/*
+	*	Writes, reads and compares a single field type for the reflection serializers
+	*	Trivially copyable types are copied byte for byte, specialize this for any other field type, e.g. containers
+	*/
+	template<typename F, typename Enable = void>
+	struct FieldSerializer
+	{
+		static_assert( std::is_trivially_copyable_v<F>, "Specialize FieldSerializer for reflected fields that are not trivially copyable" );
+
+		static void Write( const F& field, std::vector<uint8_t>& out )
+		{
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>( &field );
+			out.insert( out.end(), bytes, bytes + sizeof( F ) );
+		}
+
+		static bool Read( F& field, const uint8_t*& in, const uint8_t* end )
+		{
+			if( static_cast<size_t>( end - in ) < sizeof( F ) )
+			{
+				return false;
+			}
+			std::memcpy( &field, in, sizeof( F ) );
+			in += sizeof( F );
+			return true;
+		}
+
+		static bool Equals( const F& a, const F& b )
+		{
+			return std::memcmp( &a, &b, sizeof( F ) ) == 0;
+		}
+	};
+
+	// Strings are written as their length followed by their characters
+	template<>
+	struct FieldSerializer<std::string>
+	{
+		static void Write( const std::string& field, std::vector<uint8_t>& out )
+		{
+			FieldSerializer<uint32_t>::Write( static_cast<uint32_t>( field.size() ), out );
+			out.insert( out.end(), field.begin(), field.end() );
+		}
+
+		static bool Read( std::string& field, const uint8_t*& in, const uint8_t* end )
+		{
+			uint32_t size = 0;
+			if( !FieldSerializer<uint32_t>::Read( size, in, end ) || static_cast<size_t>( end - in ) < size )
+			{
+				return false;
+			}
+			field.assign( reinterpret_cast<const char*>( in ), size );
+			in += size;
+			return true;
+		}
+
+		static bool Equals( const std::string& a, const std::string& b )
+		{
+			return a == b;
+		}
+	};
+
+	// Vectors of trivially copyable elements are written as their size followed by their elements
+	template<typename E>
+	struct FieldSerializer<std::vector<E>, std::enable_if_t<std::is_trivially_copyable_v<E>>>
+	{
+		static void Write( const std::vector<E>& field, std::vector<uint8_t>& out )
+		{
+			FieldSerializer<uint32_t>::Write( static_cast<uint32_t>( field.size() ), out );
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>( field.data() );
+			out.insert( out.end(), bytes, bytes + field.size() * sizeof( E ) );
+		}
+
+		static bool Read( std::vector<E>& field, const uint8_t*& in, const uint8_t* end )
+		{
+			uint32_t size = 0;
+			if( !FieldSerializer<uint32_t>::Read( size, in, end ) || static_cast<size_t>( end - in ) / sizeof( E ) < size )
+			{
+				return false;
+			}
+			field.resize( size );
+			std::memcpy( field.data(), in, size * sizeof( E ) );
+			in += size * sizeof( E );
+			return true;
+		}
+
+		static bool Equals( const std::vector<E>& a, const std::vector<E>& b )
+		{
+			return a.size() == b.size() && std::memcmp( a.data(), b.data(), a.size() * sizeof( E ) ) == 0;
+		}
+	};
+
+
+	/*
+	*	Describes a single reflected field
+	*	Fields that are not trivially copyable are handled through the FieldSerializer functions, the others are copied with memcpy
+	*/
+	struct FieldInfo
+	{
+		const char*		m_name;
+
+		// Byte offset of the field from the start of the reflected type
+		uint32_t		m_offset;
+
+		uint32_t		m_size;
+
+		bool			m_bTriviallyCopyable;
+
+		void ( *m_write )( const void* field, std::vector<uint8_t>& out );
+		bool ( *m_read )( void* field, const uint8_t*& in, const uint8_t* end );
+		bool ( *m_equals )( const void* a, const void* b );
+		void ( *m_copy )( const void* from, void* to );
+	};
+
+	// A run of adjacent trivially copyable fields, copied with a single memcpy
+	struct FieldRun
+	{
+		uint32_t		m_offset;
+		uint32_t		m_size;
+	};
+
+	/*
+	*	The reflection metadata of a component type, created once per type by ECS_REFLECT
+	*/
+	struct TypeInfo
+	{
+		uint64_t				m_componentType;
+
+		const char*				m_name;
+
+		size_t					m_size;
+
+		// Byte offset of the Component base from the start of the reflected type, field offsets are relative to the reflected type
+		uint32_t				m_componentOffset;
+
+		std::vector<FieldInfo>	m_fields;
+
+		// The trivially copyable fields merged into runs of adjacent bytes, only used when m_bTriviallyCopyable is set
+		std::vector<FieldRun>	m_runs;
+
+		// True, if every field is trivially copyable, the whole component is then serialized as m_runs
+		bool					m_bTriviallyCopyable;
+
+		// Returns the index of the field with the passed name, -1 if there is none
+		int FindField( const char* name ) const
+		{
+			for( size_t i = 0; i < m_fields.size(); ++i )
+			{
+				if( std::strcmp( m_fields[i].m_name, name ) == 0 )
+				{
+					return static_cast<int>( i );
+				}
+			}
+			return -1;
+		}
+	};
+
+
+	/*
+	*	Lookup of the TypeInfo of every reflected component type by its component type id
+	*	Types are kept in a fixed size open addressing table, lookups do not lock and can run on any thread while types register
+	*/
+	class TypeRegistry
+	{
+	public:
+		TypeRegistry() = delete;	// Static class, no constructor needed
+
+		/*
+		*	Adds the passed type, which must outlive the registry, replacing any type with the same component type id
+		*	@return	bool:	Returns false, if MAX_REFLECTED_TYPES types are already registered
+		*/
+		static bool Register( const TypeInfo* typeInfo );
+
+		// Returns the reflection metadata of the passed component type, nullptr if the type is not reflected
+		static const TypeInfo* Find( uint64_t componentType );
+
+		// Returns every reflected type, sorted by component type id
+		static std::vector<const TypeInfo*> GetTypes();
+	};
+
+
+	// Specialized for each reflected type by ECS_REFLECT
+	template<typename T>
+	struct Reflection
+	{
+		static constexpr bool IS_REFLECTED = false;
+	};
+
+
+	namespace ReflectionDetail
+	{
+		// Raw storage for a <T>, offsets are taken against it so no <T> is constructed
+		template<typename T>
+		inline const unsigned char* GetOffsetStorage()
+		{
+			alignas( T ) static unsigned char storage[sizeof( T )];
+			return storage;
+		}
+
+		// Offset of a member
+		template<typename T, typename F>
+		inline uint32_t GetFieldOffset( F T::* member )
+		{
+			const T* object = reinterpret_cast<const T*>( GetOffsetStorage<T>() );
+			return static_cast<uint32_t>( reinterpret_cast<const unsigned char*>( &( object->*member ) ) - GetOffsetStorage<T>() );
+		}
+
+		// Offset of the Component base, not 0 when <T> derives from another type before Component
+		template<typename T>
+		inline uint32_t GetComponentOffset()
+		{
+			const T* object = reinterpret_cast<const T*>( GetOffsetStorage<T>() );
+			return static_cast<uint32_t>( reinterpret_cast<const unsigned char*>( static_cast<const Component*>( object ) ) - GetOffsetStorage<T>() );
+		}
+
+		template<typename T, typename F>
+		inline FieldInfo MakeField( const char* name, F T::* member )
+		{
+			FieldInfo field;
+			field.m_name = name;
+			field.m_offset = GetFieldOffset( member );
+			field.m_size = static_cast<uint32_t>( sizeof( F ) );
+			field.m_bTriviallyCopyable = std::is_trivially_copyable_v<F>;
+			field.m_write = []( const void* value, std::vector<uint8_t>& out ) { FieldSerializer<F>::Write( *static_cast<const F*>( value ), out ); };
+			field.m_read = []( void* value, const uint8_t*& in, const uint8_t* end ) { return FieldSerializer<F>::Read( *static_cast<F*>( value ), in, end ); };
+			field.m_equals = []( const void* a, const void* b ) { return FieldSerializer<F>::Equals( *static_cast<const F*>( a ), *static_cast<const F*>( b ) ); };
+			field.m_copy = []( const void* from, void* to ) { *static_cast<F*>( to ) = *static_cast<const F*>( from ); };
+			return field;
+		}
+
+		// Builds the TypeInfo of <T> and merges adjacent trivially copyable fields into runs
+		template<typename T>
+		TypeInfo MakeTypeInfo( const char* name, std::vector<FieldInfo> fields )
+		{
+			// Complile-time check to see if class T can be converted to class B,
+				// valid for derivation check of class T from class B
+			CanConvert_From<T, Component>();
+
+			if( fields.size() > MAX_REFLECTED_FIELDS )
+			{
+				fields.resize( MAX_REFLECTED_FIELDS );
+			}
+
+			TypeInfo info;
+			info.m_componentType = T::ID;
+			info.m_name = name;
+			info.m_size = sizeof( T );
+			info.m_componentOffset = GetComponentOffset<T>();
+			info.m_fields = std::move( fields );
+			info.m_bTriviallyCopyable = true;
+
+			for( const FieldInfo& field : info.m_fields )
+			{
+				info.m_bTriviallyCopyable = info.m_bTriviallyCopyable && field.m_bTriviallyCopyable;
+				if( !field.m_bTriviallyCopyable )
+				{
+					continue;
+				}
+
+				if( !info.m_runs.empty() && info.m_runs.back().m_offset + info.m_runs.back().m_size == field.m_offset )
+				{
+					info.m_runs.back().m_size += field.m_size;
+				}
+				else
+				{
+					info.m_runs.push_back( { field.m_offset, field.m_size } );
+				}
+			}
+
+			return info;
+		}
+	}
+
+
+	/*
+	*	Appends the reflected fields of the passed component to 'out', the component's type must be reflected
+	*	@return	bool:	Returns false, if the component's type is not reflected
+	*/
+	bool SerializeComponent( const Component& component, std::vector<uint8_t>& out );
+
+	/*
+	*	Appends the reflected fields of the passed component, which must be of the type described by 'info'
+	*	Avoids the registry lookup when serializing many components of one type
+	*/
+	void SerializeComponent( const TypeInfo& info, const Component& component, std::vector<uint8_t>& out );
+
+	/*
+	*	Reads the fields written by SerializeComponent into the passed component, advancing 'in'
+	*	@return	bool:	Returns false, if the type is not reflected or the data ran out
+	*/
+	bool DeserializeComponent( Component& component, const uint8_t*& in, const uint8_t* end );
+
+	// Reads the fields written by SerializeComponent into the passed component, which must be of the type described by 'info'
+	bool DeserializeComponent( const TypeInfo& info, Component& component, const uint8_t*& in, const uint8_t* end );
+
+	/*
+	*	Compares two components of the same reflected type field by field
+	*	@return	uint64_t:	A mask with bit i set for each field i that differs, 0 if they are equal or not comparable
+	*/
+	uint64_t DiffComponents( const Component& a, const Component& b );
+
+	// Compares two components field by field, both must be of the type described by 'info'
+	uint64_t DiffComponents( const TypeInfo& info, const Component& a, const Component& b );
+
+	/*
+	*	Appends the mask of the fields of 'current' that differ from 'baseline', followed by only those fields
+	*	@return	uint64_t:	The mask of changed fields
+	*/
+	uint64_t SerializeComponentDelta( const Component& current, const Component& baseline, std::vector<uint8_t>& out );
+
+	// Appends the delta of 'current' against 'baseline', both must be of the type described by 'info'
+	uint64_t SerializeComponentDelta( const TypeInfo& info, const Component& current, const Component& baseline, std::vector<uint8_t>& out );
+
+	/*
+	*	Copies the reflected fields of 'from' into 'to', both must be of the type described by 'info', fields that are not reflected are left as they are
+	*	Used to copy values into components whose type can not be copy constructed, e.g. prefab instances
+	*/
+	void CopyComponentFields( const TypeInfo& info, const Component& from, Component& to );
+
+	/*
+	*	Applies a delta written by SerializeComponentDelta onto the passed component, which should hold the delta's baseline
+	*	@return	bool:	Returns false, if the type is not reflected or the data ran out
+	*/
+	bool ApplyComponentDelta( Component& component, const uint8_t*& in, const uint8_t* end );
+
+	// Applies a delta written by SerializeComponentDelta onto the passed component, which must be of the type described by 'info'
+	bool ApplyComponentDelta( const TypeInfo& info, Component& component, const uint8_t*& in, const uint8_t* end );
+
+}
+
+
+// Expansion helpers for ECS_REFLECT, the extra ECS_REFLECT_EXPAND keeps MSVC's preprocessor from passing __VA_ARGS__ on as one argument
+#define ECS_REFLECT_EXPAND( x ) x
+#define ECS_REFLECT_FIELD( Type, name ) ::ECS::ReflectionDetail::MakeField( #name, &Type::name )
+#define ECS_REFLECT_F1( T, a ) ECS_REFLECT_FIELD( T, a )
+#define ECS_REFLECT_F2( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F1( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F3( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F2( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F4( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F3( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F5( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F4( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F6( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F5( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F7( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F6( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F8( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F7( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F9( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F8( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F10( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F9( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F11( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F10( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F12( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F11( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F13( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F12( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F14( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F13( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F15( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F14( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_F16( T, a, ... ) ECS_REFLECT_FIELD( T, a ), ECS_REFLECT_EXPAND( ECS_REFLECT_F15( T, __VA_ARGS__ ) )
+#define ECS_REFLECT_SELECT( _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, NAME, ... ) NAME
+#define ECS_REFLECT_FIELDS( T, ... ) ECS_REFLECT_EXPAND( ECS_REFLECT_SELECT( __VA_ARGS__, ECS_REFLECT_F16, ECS_REFLECT_F15, ECS_REFLECT_F14, ECS_REFLECT_F13, ECS_REFLECT_F12, ECS_REFLECT_F11, ECS_REFLECT_F10, ECS_REFLECT_F9, ECS_REFLECT_F8, ECS_REFLECT_F7, ECS_REFLECT_F6, ECS_REFLECT_F5, ECS_REFLECT_F4, ECS_REFLECT_F3, ECS_REFLECT_F2, ECS_REFLECT_F1 )( T, __VA_ARGS__ ) )
+
+/*
+*	Reflects up to 16 fields of a component type, used at global namespace scope after the type, e.g.
+*		ECS_REFLECT( Health, m_current, m_max, m_regeneration )
+*	The type is registered with the TypeRegistry during static initialization, private fields need 'template<typename> friend struct ECS::Reflection;'
+*/
+#define ECS_REFLECT( Type, ... ) \
+	template<> \
+	struct ECS::Reflection<Type> \
+	{ \
+		static constexpr bool IS_REFLECTED = true; \
+		static const ::ECS::TypeInfo& Get() \
+		{ \
+			static const ::ECS::TypeInfo info = ::ECS::ReflectionDetail::MakeTypeInfo<Type>( #Type, { ECS_REFLECT_FIELDS( Type, __VA_ARGS__ ) } ); \
+			static const bool bRegistered = ::ECS::TypeRegistry::Register( &info ); \
+			( void )bRegistered; \
+			return info; \
+		} \
+		static inline const bool REGISTERED = ( Get(), true ); \
+	};
+
+#endif // !REFLECTION_H
@@ -0,0 +1,89 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#include "Replication.h"
+
+namespace ECS
+{
+
+	uint64_t ReplicationEncoder::Encode( std::vector<uint8_t>& stream )
+	{
+		stream.clear();
+
+		const uint64_t sequence = ++m_sequence;
+
+		// The baseline can only be used while its state is still held in the history
+		uint64_t baseline = 0;
+		if( m_acknowledgedSequence != 0 && sequence - m_acknowledgedSequence < REPLICATION_HISTORY )
+		{
+			baseline = m_acknowledgedSequence;
+		}
+
+		BitWriter writer( stream );
+		writer.WriteVarUint( sequence );
+		writer.WriteVarUint( baseline );
+		writer.WriteVarUint( m_types.size() );
+
+		for( IReplicatedType* type : m_types )
+		{
+			type->Encode( writer, m_world->m_componentManager->m_componentMap[type->GetComponentType()], sequence, baseline );
+		}
+
+		writer.Flush();
+
+		return sequence;
+	}
+
+	void ReplicationEncoder::Acknowledge( uint64_t sequence )
+	{
+		// Acknowledgements can arrive out of order, only move the baseline forward
+		if( sequence > m_acknowledgedSequence && sequence <= m_sequence )
+		{
+			m_acknowledgedSequence = sequence;
+		}
+	}
+
+	bool ReplicationDecoder::Apply( const uint8_t* data, size_t size )
+	{
+		if( m_replica == nullptr || data == nullptr )
+		{
+			return false;
+		}
+
+		BitReader reader( data, size );
+
+		const uint64_t sequence = reader.ReadVarUint();
+		const uint64_t baseline = reader.ReadVarUint();
+		const uint64_t typeCount = reader.ReadVarUint();
+
+		if( reader.HasOverflowed() || sequence <= m_lastSequence || typeCount != m_types.size() )
+		{
+			return false;
+		}
+
+		// The stream only holds the changes since the baseline, which must be a state this decoder still holds
+		if( baseline != 0 && ( baseline >= sequence || m_receivedSequences[baseline % REPLICATION_HISTORY] != baseline ) )
+		{
+			return false;
+		}
+
+		for( IReplicatedType* type : m_types )
+		{
+			if( !type->Decode( reader, baseline ) )
+			{
+				return false;
+			}
+		}
+
+		// The whole stream was valid, only now is the replica changed
+		for( IReplicatedType* type : m_types )
+		{
+			type->Commit( *m_replica, m_remoteToLocal, sequence, m_lastSequence );
+		}
+
+		m_receivedSequences[sequence % REPLICATION_HISTORY] = sequence;
+		m_lastSequence = sequence;
+
+		return true;
+	}
+
+};
@@ -0,0 +1,802 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include "ECS_Definitions.h"
+#include "Component.h"
+#include "World.h"
+
+#include "Utility/BitStream.h"
+#include "Utility/TemplateHelper.h"
+
+#include "../../Math/include/Quaternion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace ECS
+{
+	// Number of sent states each encoder keeps, a baseline older than this can no longer be diffed against
+	static constexpr size_t REPLICATION_HISTORY { 32 };
+
+	enum class ReplicatedFieldType : uint8_t
+	{
+		Float = 0,
+		Integer = 1,
+		Vector3 = 2,
+		Quaternion = 3
+	};
+
+	/*
+	*	Describes a single replicated field of the component type <T> and how it is quantized
+	*/
+	template<typename T>
+	struct ReplicatedField
+	{
+		ReplicatedFieldType		m_type;
+
+		// Bits per value, per axis for Vector3 and per smallest-three component for Quaternion
+		uint32_t				m_bits;
+
+		// The range values are clamped to before being quantized, unused by Integer and Quaternion fields
+		float					m_min;
+		float					m_max;
+
+		union
+		{
+			float T::*				m_float;
+			int32_t T::*			m_integer;
+			Kobe::Vector3 T::*		m_vector3;
+			Kobe::Quaternion T::*	m_quaternion;
+		};
+
+		// Number of 32 bit words the quantized field takes up
+		inline uint32_t GetWordCount() const
+		{
+			return m_type == ReplicatedFieldType::Vector3 ? 3 : 1;
+		}
+	};
+
+	// Replicates a float quantized to 'bits' bits across [min, max]
+	template<typename T>
+	ReplicatedField<T> ReplicateFloat( float T::* member, float min, float max, uint32_t bits )
+	{
+		ReplicatedField<T> field;
+		field.m_type = ReplicatedFieldType::Float;
+		field.m_bits = std::clamp<uint32_t>( bits, 1, 24 );
+		field.m_min = min;
+		field.m_max = max;
+		field.m_float = member;
+		return field;
+	}
+
+	// Replicates a signed integer using its lowest 'bits' bits, zig-zag encoded
+	template<typename T>
+	ReplicatedField<T> ReplicateInteger( int32_t T::* member, uint32_t bits = 32 )
+	{
+		ReplicatedField<T> field;
+		field.m_type = ReplicatedFieldType::Integer;
+		field.m_bits = std::clamp<uint32_t>( bits, 1, 32 );
+		field.m_min = 0.0f;
+		field.m_max = 0.0f;
+		field.m_integer = member;
+		return field;
+	}
+
+	// Replicates a Kobe::Vector3 with each axis quantized to 'bits' bits across [min, max]
+	template<typename T>
+	ReplicatedField<T> ReplicateVector3( Kobe::Vector3 T::* member, float min, float max, uint32_t bits )
+	{
+		ReplicatedField<T> field;
+		field.m_type = ReplicatedFieldType::Vector3;
+		field.m_bits = std::clamp<uint32_t>( bits, 1, 24 );
+		field.m_min = min;
+		field.m_max = max;
+		field.m_vector3 = member;
+		return field;
+	}
+
+	// Replicates a unit Kobe::Quaternion using smallest-three encoding, 2 bits plus 3 components of 'bits' bits
+	template<typename T>
+	ReplicatedField<T> ReplicateQuaternion( Kobe::Quaternion T::* member, uint32_t bits = 10 )
+	{
+		ReplicatedField<T> field;
+		field.m_type = ReplicatedFieldType::Quaternion;
+		field.m_bits = std::clamp<uint32_t>( bits, 1, 10 );
+		field.m_min = 0.0f;
+		field.m_max = 0.0f;
+		field.m_quaternion = member;
+		return field;
+	}
+
+
+	/*
+	*	Utility functions used to quantize replicated values into integer words and back
+	*/
+	struct Quantization
+	{
+		Quantization() = delete;	// Static class, no constructor needed
+
+		static inline uint32_t MaxValue( uint32_t bits )
+		{
+			return bits >= 32 ? 0xFFFFFFFFu : ( ( 1u << bits ) - 1 );
+		}
+
+		static inline uint32_t QuantizeFloat( float value, float min, float max, uint32_t bits )
+		{
+			if( max <= min )
+			{
+				return 0;
+			}
+			const double t = ( std::clamp( value, min, max ) - static_cast<double>( min ) ) / ( static_cast<double>( max ) - min );
+			return static_cast<uint32_t>( t * MaxValue( bits ) + 0.5 );
+		}
+
+		static inline float DequantizeFloat( uint32_t value, float min, float max, uint32_t bits )
+		{
+			return static_cast<float>( min + ( static_cast<double>( value ) / MaxValue( bits ) ) * ( static_cast<double>( max ) - min ) );
+		}
+
+		static inline uint32_t ZigZag( int32_t value )
+		{
+			return ( static_cast<uint32_t>( value ) << 1 ) ^ static_cast<uint32_t>( value >> 31 );
+		}
+
+		static inline int32_t UnZigZag( uint32_t value )
+		{
+			return static_cast<int32_t>( ( value >> 1 ) ^ ( ~( value & 1 ) + 1 ) );
+		}
+
+		// Packs the index of the largest component in the lowest 2 bits, followed by the three remaining components
+		static inline uint32_t QuantizeQuaternion( const Kobe::Quaternion& q, uint32_t bits )
+		{
+			const float components[4] = { q.x, q.y, q.z, q.w };
+
+			uint32_t largest = 0;
+			for( uint32_t i = 1; i < 4; ++i )
+			{
+				if( std::fabs( components[i] ) > std::fabs( components[largest] ) )
+				{
+					largest = i;
+				}
+			}
+
+			// q and -q are the same rotation, flip so the dropped component is always positive
+			const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+			uint32_t packed = largest;
+			uint32_t shift = 2;
+			for( uint32_t i = 0; i < 4; ++i )
+			{
+				if( i == largest )
+				{
+					continue;
+				}
+				packed |= QuantizeFloat( components[i] * sign, -SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE, bits ) << shift;
+				shift += bits;
+			}
+			return packed;
+		}
+
+		static inline Kobe::Quaternion DequantizeQuaternion( uint32_t packed, uint32_t bits )
+		{
+			const uint32_t largest = packed & 0x3;
+			const uint32_t mask = MaxValue( bits );
+
+			float components[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float sumOfSquares = 0.0f;
+			uint32_t shift = 2;
+			for( uint32_t i = 0; i < 4; ++i )
+			{
+				if( i == largest )
+				{
+					continue;
+				}
+				components[i] = DequantizeFloat( ( packed >> shift ) & mask, -SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE, bits );
+				sumOfSquares += components[i] * components[i];
+				shift += bits;
+			}
+			components[largest] = std::sqrt( std::max( 0.0f, 1.0f - sumOfSquares ) );
+
+			return Kobe::Quaternion( components[0], components[1], components[2], components[3] );
+		}
+
+	private:
+		// The three smallest components of a unit quaternion always lie within +/- 1/sqrt(2)
+		static constexpr float SMALLEST_THREE_RANGE { 0.70710678f };
+	};
+
+
+	/*
+	*	Interface for a replicated component type, used by both the encoder and the decoder
+	*/
+	class IReplicatedType
+	{
+	public:
+		IReplicatedType() {}
+		virtual ~IReplicatedType() {}
+
+		virtual uint64_t GetComponentType() const = 0;
+
+		/*
+		*	Quantizes the passed components as the state for 'sequence' and writes the entries that differ from the 'baseline' state
+		*	A baseline of 0 means there is no baseline, and every component is written in full
+		*/
+		virtual void Encode( BitWriter& writer, const std::vector<Component*>& components, uint64_t sequence, uint64_t baseline ) = 0;
+
+		/*
+		*	Reads the entries written by Encode and rebuilds the full state they were encoded from, the 'baseline' state plus the entries
+		*	The replica is not changed until Commit, so a malformed stream leaves it untouched
+		*	@return	bool:	Returns false, if the stream was malformed
+		*/
+		virtual bool Decode( BitReader& reader, uint64_t baseline ) = 0;
+
+		/*
+		*	Stores the state rebuilt by Decode as the state of 'sequence', and updates the replica from the 'applied' state to it
+		*	An applied sequence of 0 means nothing has been applied yet
+		*/
+		virtual void Commit( World& replica, std::vector<EntityId>& remoteToLocal, uint64_t sequence, uint64_t applied ) = 0;
+	};
+
+
+	/*
+	*	Replication state for the component type <T>
+	*	The encoder keeps the quantized state of the last REPLICATION_HISTORY sequences, stored in flat arrays indexed by EntityId
+	*	The decoder keeps the same history of the states it received, so each stream is applied as its baseline state plus the changes
+	*/
+	template<typename T>
+	class ReplicatedType : public IReplicatedType
+	{
+		// The fields replicated for this component type
+		std::vector<ReplicatedField<T>>		m_fields;
+
+		// Number of quantized words per component
+		uint32_t							m_wordsPerComponent;
+
+		// Quantized state per encoded or received sequence, indexed by [EntityId * m_wordsPerComponent]
+		std::vector<std::vector<uint32_t>>	m_history;
+
+		// Whether an entity had this component type, per sequence, indexed by EntityId
+		std::vector<std::vector<uint8_t>>	m_present;
+
+		// The last sequence each entity had this component type in
+		std::vector<uint64_t>				m_lastPresentSequence;
+
+		// The sequence each entity most recently gained this component type in
+		std::vector<uint64_t>				m_addedSequence;
+
+		// The largest EntityId encoded or decoded so far
+		EntityId							m_maxEntityId;
+
+		// Decoder only, the replica's component for each remote EntityId
+		std::vector<T*>						m_replicaComponents;
+
+		// Decoder only, the state rebuilt by the last Decode, stored into m_history by Commit
+		std::vector<uint32_t>				m_decodedWords;
+		std::vector<uint8_t>				m_decodedPresent;
+
+	public:
+
+		explicit ReplicatedType( const std::vector<ReplicatedField<T>>& fields ) :
+			m_fields( fields ),
+			m_wordsPerComponent( 0 ),
+			m_maxEntityId( 0 )
+		{
+			// Complile-time check to see if class T can be converted to class B,
+				// valid for derivation check of class T from class B
+			CanConvert_From<T, Component>();
+
+			// Changed fields are sent as a 32 bit mask
+			if( m_fields.size() > 32 )
+			{
+				m_fields.resize( 32 );
+			}
+
+			for( const ReplicatedField<T>& field : m_fields )
+			{
+				m_wordsPerComponent += field.GetWordCount();
+			}
+		}
+
+		virtual ~ReplicatedType() {}
+
+		virtual uint64_t GetComponentType() const override { return T::ID; }
+
+		virtual void Encode( BitWriter& writer, const std::vector<Component*>& components, uint64_t sequence, uint64_t baseline ) override
+		{
+			if( m_history.empty() )
+			{
+				// Allocated once on the first encode, every later encode reuses these buffers
+				AllocateHistory();
+				m_lastPresentSequence.assign( MAX_ENTITY_ID + 1, 0 );
+				m_addedSequence.assign( MAX_ENTITY_ID + 1, 0 );
+			}
+
+			const size_t slot = static_cast<size_t>( sequence % REPLICATION_HISTORY );
+
+			std::vector<uint32_t>& words = m_history[slot];
+			std::vector<uint8_t>& present = m_present[slot];
+			std::fill( present.begin(), present.end(), 0 );
+
+			// Quantize the current state
+			for( Component* c : components )
+			{
+				const EntityId entityId = c->GetOwnerEntity();
+				if( entityId > MAX_ENTITY_ID || present[entityId] )	// Only the first component of this type on an entity is replicated
+				{
+					continue;
+				}
+
+				present[entityId] = 1;
+				Quantize( static_cast<const T*>( c ), &words[entityId * m_wordsPerComponent] );
+
+				if( m_lastPresentSequence[entityId] == 0 || m_lastPresentSequence[entityId] != sequence - 1 )	// Gained the component since the last encode
+				{
+					m_addedSequence[entityId] = sequence;
+				}
+				m_lastPresentSequence[entityId] = sequence;
+				m_maxEntityId = std::max( m_maxEntityId, entityId );
+			}
+
+			const uint32_t* baseWords = baseline != 0 ? m_history[baseline % REPLICATION_HISTORY].data() : nullptr;
+			const uint8_t* basePresent = baseline != 0 ? m_present[baseline % REPLICATION_HISTORY].data() : nullptr;
+
+			writer.Write( static_cast<uint32_t>( T::ID ), 32 );
+
+			EntityId previousId = 0;
+			for( EntityId entityId = 1; entityId <= m_maxEntityId; ++entityId )
+			{
+				const uint32_t* current = &words[entityId * m_wordsPerComponent];
+
+				if( present[entityId] )
+				{
+					const bool bFull = basePresent == nullptr || !basePresent[entityId] || m_addedSequence[entityId] > baseline;
+
+					uint32_t changedMask = 0;
+					if( !bFull )
+					{
+						changedMask = DiffFields( current, baseWords + entityId * m_wordsPerComponent );
+						if( changedMask == 0 )	// Nothing changed since the baseline
+						{
+							continue;
+						}
+					}
+
+					WriteEntryHeader( writer, entityId, previousId, false );
+					writer.WriteBool( bFull );
+					if( !bFull )
+					{
+						writer.Write( changedMask, static_cast<uint32_t>( m_fields.size() ) );
+					}
+					WriteFields( writer, current, bFull ? 0xFFFFFFFFu : changedMask );
+				}
+				else if( m_lastPresentSequence[entityId] != 0 && m_lastPresentSequence[entityId] >= baseline )
+				{
+					// The component existed at some point since the baseline and has been removed
+					WriteEntryHeader( writer, entityId, previousId, true );
+				}
+			}
+
+			// End of entries for this type
+			writer.WriteBool( false );
+		}
+
+		virtual bool Decode( BitReader& reader, uint64_t baseline ) override
+		{
+			if( reader.Read( 32 ) != static_cast<uint32_t>( T::ID ) )	// The encoder registered a different type in this position
+			{
+				return false;
+			}
+
+			if( m_history.empty() )
+			{
+				// Allocated once on the first decode, every later decode reuses these buffers
+				AllocateHistory();
+				m_replicaComponents.assign( MAX_ENTITY_ID + 1, nullptr );
+			}
+
+			// Start from the baseline state, the entries only hold what changed since then
+			if( baseline != 0 )
+			{
+				const size_t baselineSlot = static_cast<size_t>( baseline % REPLICATION_HISTORY );
+				m_decodedWords = m_history[baselineSlot];
+				m_decodedPresent = m_present[baselineSlot];
+			}
+			else
+			{
+				m_decodedWords.assign( ( MAX_ENTITY_ID + 1 ) * m_wordsPerComponent, 0 );
+				m_decodedPresent.assign( MAX_ENTITY_ID + 1, 0 );
+			}
+
+			EntityId remoteId = 0;
+			while( reader.ReadBool() )
+			{
+				remoteId += reader.ReadVarUint();
+				if( reader.HasOverflowed() || remoteId > MAX_ENTITY_ID )
+				{
+					return false;
+				}
+
+				m_maxEntityId = std::max( m_maxEntityId, remoteId );
+
+				const bool bRemoved = reader.ReadBool();
+				if( bRemoved )
+				{
+					m_decodedPresent[remoteId] = 0;
+					continue;
+				}
+
+				const bool bFull = reader.ReadBool();
+				if( !bFull && !m_decodedPresent[remoteId] )	// A change to a component the baseline does not have
+				{
+					return false;
+				}
+
+				const uint32_t changedMask = bFull ? 0xFFFFFFFFu : reader.Read( static_cast<uint32_t>( m_fields.size() ) );
+				ReadFields( reader, &m_decodedWords[remoteId * m_wordsPerComponent], changedMask );
+				m_decodedPresent[remoteId] = 1;
+			}
+
+			return !reader.HasOverflowed();
+		}
+
+		virtual void Commit( World& replica, std::vector<EntityId>& remoteToLocal, uint64_t sequence, uint64_t applied ) override
+		{
+			const uint32_t* appliedWords = applied != 0 ? m_history[applied % REPLICATION_HISTORY].data() : nullptr;
+			const uint8_t* appliedPresent = applied != 0 ? m_present[applied % REPLICATION_HISTORY].data() : nullptr;
+
+			// Only the components that differ from the applied state are touched
+			for( EntityId remoteId = 1; remoteId <= m_maxEntityId; ++remoteId )
+			{
+				if( !m_decodedPresent[remoteId] )
+				{
+					if( m_replicaComponents[remoteId] != nullptr )
+					{
+						replica.RemoveComponentFromEntity<T>( remoteToLocal[remoteId] );
+						m_replicaComponents[remoteId] = nullptr;
+					}
+					continue;
+				}
+
+				const uint32_t* current = &m_decodedWords[remoteId * m_wordsPerComponent];
+
+				T* component = m_replicaComponents[remoteId];
+				uint32_t changedMask = 0xFFFFFFFFu;
+				if( component == nullptr )
+				{
+					component = CreateReplicaComponent( replica, remoteId, remoteToLocal );
+					if( component == nullptr )	// The replica is at capacity, it is retried with the next stream
+					{
+						continue;
+					}
+				}
+				else if( appliedPresent != nullptr && appliedPresent[remoteId] )
+				{
+					changedMask = DiffFields( current, appliedWords + remoteId * m_wordsPerComponent );
+				}
+
+				if( changedMask != 0 )
+				{
+					Dequantize( current, changedMask, component );
+				}
+			}
+
+			// Stored after the diff, the new sequence can share its slot with the applied one
+			const size_t slot = static_cast<size_t>( sequence % REPLICATION_HISTORY );
+			std::swap( m_history[slot], m_decodedWords );
+			std::swap( m_present[slot], m_decodedPresent );
+		}
+
+	private:
+
+		void AllocateHistory()
+		{
+			m_history.assign( REPLICATION_HISTORY, std::vector<uint32_t>( ( MAX_ENTITY_ID + 1 ) * m_wordsPerComponent, 0 ) );
+			m_present.assign( REPLICATION_HISTORY, std::vector<uint8_t>( MAX_ENTITY_ID + 1, 0 ) );
+		}
+
+		inline void WriteEntryHeader( BitWriter& writer, EntityId entityId, EntityId& previousId, bool bRemoved ) const
+		{
+			writer.WriteBool( true );
+			writer.WriteVarUint( entityId - previousId );
+			writer.WriteBool( bRemoved );
+			previousId = entityId;
+		}
+
+		void Quantize( const T* component, uint32_t* words ) const
+		{
+			for( const ReplicatedField<T>& field : m_fields )
+			{
+				switch( field.m_type )
+				{
+				case ReplicatedFieldType::Float:
+					*words++ = Quantization::QuantizeFloat( component->*field.m_float, field.m_min, field.m_max, field.m_bits );
+					break;
+				case ReplicatedFieldType::Integer:
+					*words++ = Quantization::ZigZag( component->*field.m_integer ) & Quantization::MaxValue( field.m_bits );
+					break;
+				case ReplicatedFieldType::Vector3:
+				{
+					const Kobe::Vector3& v = component->*field.m_vector3;
+					*words++ = Quantization::QuantizeFloat( v.x, field.m_min, field.m_max, field.m_bits );
+					*words++ = Quantization::QuantizeFloat( v.y, field.m_min, field.m_max, field.m_bits );
+					*words++ = Quantization::QuantizeFloat( v.z, field.m_min, field.m_max, field.m_bits );
+					break;
+				}
+				case ReplicatedFieldType::Quaternion:
+					*words++ = Quantization::QuantizeQuaternion( component->*field.m_quaternion, field.m_bits );
+					break;
+				}
+			}
+		}
+
+		void Dequantize( const uint32_t* words, uint32_t changedMask, T* component ) const
+		{
+			for( size_t i = 0; i < m_fields.size(); ++i )
+			{
+				const ReplicatedField<T>& field = m_fields[i];
+				const bool bChanged = ( changedMask >> i ) & 1;
+
+				if( bChanged )
+				{
+					switch( field.m_type )
+					{
+					case ReplicatedFieldType::Float:
+						component->*field.m_float = Quantization::DequantizeFloat( words[0], field.m_min, field.m_max, field.m_bits );
+						break;
+					case ReplicatedFieldType::Integer:
+						component->*field.m_integer = Quantization::UnZigZag( words[0] );
+						break;
+					case ReplicatedFieldType::Vector3:
+						( component->*field.m_vector3 ).Load(
+							Quantization::DequantizeFloat( words[0], field.m_min, field.m_max, field.m_bits ),
+							Quantization::DequantizeFloat( words[1], field.m_min, field.m_max, field.m_bits ),
+							Quantization::DequantizeFloat( words[2], field.m_min, field.m_max, field.m_bits ) );
+						break;
+					case ReplicatedFieldType::Quaternion:
+						component->*field.m_quaternion = Quantization::DequantizeQuaternion( words[0], field.m_bits );
+						break;
+					}
+				}
+
+				words += field.GetWordCount();
+			}
+		}
+
+		// Returns a mask with a bit set for each field whose quantized value differs from the baseline
+		uint32_t DiffFields( const uint32_t* current, const uint32_t* baseline ) const
+		{
+			uint32_t changedMask = 0;
+			for( size_t i = 0; i < m_fields.size(); ++i )
+			{
+				const uint32_t wordCount = m_fields[i].GetWordCount();
+				for( uint32_t w = 0; w < wordCount; ++w )
+				{
+					if( current[w] != baseline[w] )
+					{
+						changedMask |= 1u << i;
+						break;
+					}
+				}
+				current += wordCount;
+				baseline += wordCount;
+			}
+			return changedMask;
+		}
+
+		void WriteFields( BitWriter& writer, const uint32_t* words, uint32_t changedMask ) const
+		{
+			for( size_t i = 0; i < m_fields.size(); ++i )
+			{
+				const ReplicatedField<T>& field = m_fields[i];
+				if( ( changedMask >> i ) & 1 )
+				{
+					if( field.m_type == ReplicatedFieldType::Quaternion )
+					{
+						writer.Write( words[0], 2 + field.m_bits * 3 );
+					}
+					else
+					{
+						for( uint32_t w = 0; w < field.GetWordCount(); ++w )
+						{
+							writer.Write( words[w], field.m_bits );
+						}
+					}
+				}
+				words += field.GetWordCount();
+			}
+		}
+
+		void ReadFields( BitReader& reader, uint32_t* words, uint32_t changedMask ) const
+		{
+			for( size_t i = 0; i < m_fields.size(); ++i )
+			{
+				const ReplicatedField<T>& field = m_fields[i];
+				if( ( changedMask >> i ) & 1 )
+				{
+					if( field.m_type == ReplicatedFieldType::Quaternion )
+					{
+						words[0] = reader.Read( 2 + field.m_bits * 3 );
+					}
+					else
+					{
+						for( uint32_t w = 0; w < field.GetWordCount(); ++w )
+						{
+							words[w] = reader.Read( field.m_bits );
+						}
+					}
+				}
+				words += field.GetWordCount();
+			}
+		}
+
+		T* CreateReplicaComponent( World& replica, EntityId remoteId, std::vector<EntityId>& remoteToLocal )
+		{
+			if( remoteToLocal[remoteId] == 0 )
+			{
+				std::vector<EntityId> created = replica.CreateEntities( 1 );
+				if( created.empty() )	// The replica is at capacity
+				{
+					return nullptr;
+				}
+				remoteToLocal[remoteId] = created[0];
+			}
+
+			T* component = replica.AddComponentToEntity<T>( remoteToLocal[remoteId] );
+			m_replicaComponents[remoteId] = component;
+			return component;
+		}
+
+	};
+
+
+	/*
+	*	Encodes the registered component types of a World into a compact byte stream
+	*	Each stream only holds the fields that changed since the last state acknowledged by the receiver
+	*/
+	class ReplicationEncoder
+	{
+		// The world being replicated
+		World*							m_world;
+
+		// The replicated component types, in registration order
+		std::vector<IReplicatedType*>	m_types;
+
+		// The sequence number of the last encoded stream
+		uint64_t						m_sequence;
+
+		// The last sequence acknowledged by the receiver, 0 when nothing has been acknowledged
+		uint64_t						m_acknowledgedSequence;
+
+	public:
+
+		explicit ReplicationEncoder( World* world ) :
+			m_world( world ),
+			m_types(),
+			m_sequence( 0 ),
+			m_acknowledgedSequence( 0 )
+		{}
+
+		~ReplicationEncoder()
+		{
+			for( IReplicatedType* type : m_types )
+			{
+				delete type, type = nullptr;
+			}
+			m_types.clear();
+		}
+
+		ReplicationEncoder( const ReplicationEncoder& ) = delete;
+		ReplicationEncoder& operator=( const ReplicationEncoder& ) = delete;
+		ReplicationEncoder( ReplicationEncoder&& ) = delete;
+		ReplicationEncoder& operator=( ReplicationEncoder&& ) = delete;
+
+		/*
+		*	Registers the component type <T> for replication, the decoder must register the same types with the same fields, in the same order
+		*	@param	Fields:		The replicated fields, created with ReplicateFloat, ReplicateInteger, ReplicateVector3 or ReplicateQuaternion
+		*/
+		template<typename T, typename ... Fields>
+		void RegisterComponent( Fields ... fields )
+		{
+			m_types.push_back( new ReplicatedType<T>( { fields ... } ) );
+		}
+
+		/*
+		*	Encodes the current state of the world, diffed against the last acknowledged state
+		*	@param	vector:		The stream to write into, it is cleared first
+		*	@return	uint64_t:	The sequence number of the encoded state, to be acknowledged by the receiver
+		*/
+		uint64_t Encode( std::vector<uint8_t>& stream );
+
+		/*
+		*	Marks the passed sequence as received, later streams are diffed against it
+		*	@param	uint64_t:	The sequence number received by the decoder
+		*/
+		void Acknowledge( uint64_t sequence );
+
+		inline uint64_t GetSequence() const { return m_sequence; }
+
+	};
+
+
+	/*
+	*	Applies the streams written by a ReplicationEncoder to a replica World
+	*	Entities and components are created in the replica as they are first received, the replica should not be modified otherwise
+	*/
+	class ReplicationDecoder
+	{
+		// The world the streams are applied to
+		World*							m_replica;
+
+		// The replicated component types, in registration order
+		std::vector<IReplicatedType*>	m_types;
+
+		// The replica's EntityId for each remote EntityId
+		std::vector<EntityId>			m_remoteToLocal;
+
+		// The sequence number of the last applied stream
+		uint64_t						m_lastSequence;
+
+		// The sequence whose state each history slot holds, indexed by sequence % REPLICATION_HISTORY
+		std::vector<uint64_t>			m_receivedSequences;
+
+	public:
+
+		explicit ReplicationDecoder( World* replica ) :
+			m_replica( replica ),
+			m_types(),
+			m_remoteToLocal( MAX_ENTITY_ID + 1, 0 ),
+			m_lastSequence( 0 ),
+			m_receivedSequences( REPLICATION_HISTORY, 0 )
+		{}
+
+		~ReplicationDecoder()
+		{
+			for( IReplicatedType* type : m_types )
+			{
+				delete type, type = nullptr;
+			}
+			m_types.clear();
+		}
+
+		ReplicationDecoder( const ReplicationDecoder& ) = delete;
+		ReplicationDecoder& operator=( const ReplicationDecoder& ) = delete;
+		ReplicationDecoder( ReplicationDecoder&& ) = delete;
+		ReplicationDecoder& operator=( ReplicationDecoder&& ) = delete;
+
+		// Registers the component type <T>, matching the encoder's registration
+		template<typename T, typename ... Fields>
+		void RegisterComponent( Fields ... fields )
+		{
+			m_types.push_back( new ReplicatedType<T>( { fields ... } ) );
+		}
+
+		/*
+		*	Applies the passed stream to the replica world, streams older than the last applied stream are ignored
+		*	Streams are diffed against a baseline, streams whose baseline state is no longer held by the decoder are rejected
+		*	@return	bool:	Returns true, if the stream was applied. Returns false, if it was out of date, its baseline is unknown or it was malformed
+		*/
+		bool Apply( const uint8_t* data, size_t size );
+
+		inline bool Apply( const std::vector<uint8_t>& stream )
+		{
+			return Apply( stream.data(), stream.size() );
+		}
+
+		// Returns the sequence number to acknowledge back to the encoder
+		inline uint64_t GetLastSequence() const { return m_lastSequence; }
+
+		// Returns the replica's EntityId for the passed remote EntityId, returning 0 if it has not been replicated
+		inline EntityId GetLocalEntity( EntityId remoteId ) const
+		{
+			return remoteId <= MAX_ENTITY_ID ? m_remoteToLocal[remoteId] : 0;
+		}
+
+	};
+
+}
+
+
+#endif // !REPLICATION_H
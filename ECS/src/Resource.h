@@ -0,0 +1,47 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef RESOURCE_H
+#define RESOURCE_H
+
+#include "ECS_Definitions.h"
+#include "Utility/TypeIndex.h"
+
+#include <utility>
+
+namespace ECS
+{
+	/*
+	*	Resources are World level singletons (time, input, config), stored by a dense type index for O(1) access
+	*/
+	struct ResourceFamily {};
+
+	// Returns the dense index of the resource type <T>, returns MAX_RESOURCES if there are more resource types than supported
+	template<typename T>
+	size_t GetResourceIndex()
+	{
+		const size_t index = TypeIndex<ResourceFamily>::Get<T>();
+		return index < MAX_RESOURCES ? index : MAX_RESOURCES;
+	}
+
+	// Interface used by the World to own resources of any type
+	class IResource
+	{
+	public:
+		IResource() {}
+		virtual ~IResource() {}
+	};
+
+	template<typename T>
+	class Resource : public IResource
+	{
+	public:
+		template<typename ... Args>
+		explicit Resource( Args&& ... args ) : m_value( std::forward<Args>( args ) ... ) {}
+		virtual ~Resource() {}
+
+		T m_value;
+	};
+
+}
+
+#endif // !RESOURCE_H
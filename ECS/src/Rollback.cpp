@@ -0,0 +1,53 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#include "Rollback.h"
+#include "ComponentManager.h"
+
+#include <algorithm>
+
+namespace ECS
+{
+
+	uint64_t RollbackBuffer::SaveFrame()
+	{
+		const uint64_t frame = m_nextFrame;
+		const size_t frameSlot = static_cast<size_t>( frame % m_numberOfFrames );
+
+		for( IRollbackColumn* column : m_columns )
+		{
+			column->Save( m_componentManager->m_componentMap[column->GetComponentType()], frameSlot );
+		}
+
+		++m_nextFrame;
+
+		// Once the ring is full, each save overwrites the oldest frame
+		// After a restore m_nextFrame moved back, the slots overwritten before the restore must stay invalid
+		if( m_nextFrame > m_numberOfFrames )
+		{
+			m_oldestFrame = std::max( m_oldestFrame, m_nextFrame - m_numberOfFrames );
+		}
+
+		return frame;
+	}
+
+	bool RollbackBuffer::RestoreFrame( uint64_t frame )
+	{
+		if( !HasFrame( frame ) )
+		{
+			return false;
+		}
+
+		const size_t frameSlot = static_cast<size_t>( frame % m_numberOfFrames );
+
+		for( IRollbackColumn* column : m_columns )
+		{
+			column->Restore( m_componentManager->m_componentMap[column->GetComponentType()], frameSlot );
+		}
+
+		// The restored frame is now the latest, the frames after it will be saved again as the simulation re-runs
+		m_nextFrame = frame + 1;
+
+		return true;
+	}
+
+};
@@ -0,0 +1,293 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef ROLLBACK_H
+#define ROLLBACK_H
+
+#include "ECS_Definitions.h"
+#include "Component.h"
+#include "Utility/TemplateHelper.h"
+
+#include <array>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ECS
+{
+	/*
+	*	Interface for a rollback column, a column stores the saved field values of every component of one type, for each frame in the ring
+	*/
+	class IRollbackColumn
+	{
+	public:
+		IRollbackColumn() {}
+		virtual ~IRollbackColumn() {}
+
+		// The component type this column saves
+		virtual uint64_t GetComponentType() const = 0;
+
+		// Copies the registered fields of the passed components into the passed frame slot
+		virtual void Save( const std::vector<Component*>& components, size_t frameSlot ) = 0;
+
+		// Writes the registered fields saved in the passed frame slot back into the passed components
+		virtual void Restore( const std::vector<Component*>& components, size_t frameSlot ) = 0;
+	};
+
+
+	/*
+	*	Rollback column for the component type <T>, only the fields passed as member pointers are saved
+	*	Each field is stored in its own preallocated byte column, so saving a frame is a gather of memcpys with no heap traffic
+	*/
+	template<typename T, typename ... Fields>
+	class RollbackColumn : public IRollbackColumn
+	{
+		static constexpr size_t NUM_FIELDS = sizeof...( Fields );
+
+		// The saved state of every component of type <T> for a single frame
+		struct FrameColumns
+		{
+			// Number of components saved in this frame
+			size_t									m_count;
+
+			// The owning entity of each saved component, in the same order as the field columns
+			std::vector<EntityId>					m_owners;
+
+			// One tightly packed byte column per registered field
+			std::array<std::vector<uint8_t>, NUM_FIELDS>	m_fields;
+		};
+
+		// The member pointers for the fields that are saved
+		std::tuple<Fields T::* ...>		m_members;
+
+		// One set of columns per frame in the ring
+		std::vector<FrameColumns>		m_frames;
+
+	public:
+
+		RollbackColumn( size_t numberOfFrames, size_t initialCapacity, Fields T::* ... members ) :
+			m_members( members ... ),
+			m_frames( numberOfFrames )
+		{
+			// Complile-time check to see if class T can be converted to class B,
+				// valid for derivation check of class T from class B
+			CanConvert_From<T, Component>();
+
+			static_assert( ( std::is_trivially_destructible_v<Fields> && ... ), "Rollback fields must be plain data that can be copied byte for byte" );
+
+			for( FrameColumns& frame : m_frames )
+			{
+				frame.m_count = 0;
+				Reserve( frame, initialCapacity, std::index_sequence_for<Fields ...>() );
+			}
+		}
+
+		virtual ~RollbackColumn() {}
+
+		virtual uint64_t GetComponentType() const override { return T::ID; }
+
+		virtual void Save( const std::vector<Component*>& components, size_t frameSlot ) override
+		{
+			FrameColumns& frame = m_frames[frameSlot];
+
+			const size_t count = components.size();
+			if( count > frame.m_owners.size() )
+			{
+				// Only grows when there are more components than ever before, the buffers are reused afterwards
+				Reserve( frame, count, std::index_sequence_for<Fields ...>() );
+			}
+
+			frame.m_count = count;
+			for( size_t i = 0; i < count; ++i )
+			{
+				frame.m_owners[i] = components[i]->GetOwnerEntity();
+			}
+
+			SaveFields( frame, components, std::index_sequence_for<Fields ...>() );
+		}
+
+		virtual void Restore( const std::vector<Component*>& components, size_t frameSlot ) override
+		{
+			const FrameColumns& frame = m_frames[frameSlot];
+
+			const size_t size = components.size();
+			for( size_t i = 0; i < frame.m_count; ++i )
+			{
+				const EntityId ownerId = frame.m_owners[i];
+
+				// Fast path, the component has not moved since the frame was saved
+				T* component = nullptr;
+				if( i < size && components[i]->GetOwnerEntity() == ownerId )
+				{
+					component = static_cast<T*>( components[i] );
+				}
+				else
+				{
+					component = FindOwnedComponent( components, ownerId );
+				}
+
+				if( component == nullptr )	// The component was removed after this frame was saved, nothing to restore into
+				{
+					continue;
+				}
+
+				RestoreFields( frame, i, component, std::index_sequence_for<Fields ...>() );
+			}
+		}
+
+	private:
+
+		template<size_t ... INDEX>
+		void Reserve( FrameColumns& frame, size_t capacity, std::index_sequence<INDEX ...> )
+		{
+			frame.m_owners.resize( capacity );
+			( frame.m_fields[INDEX].resize( capacity * sizeof( Fields ) ), ... );
+		}
+
+		template<size_t ... INDEX>
+		void SaveFields( FrameColumns& frame, const std::vector<Component*>& components, std::index_sequence<INDEX ...> )
+		{
+			( SaveField<INDEX>( frame, components ), ... );
+		}
+
+		// Gathers a single field of every component into its column
+		template<size_t INDEX>
+		void SaveField( FrameColumns& frame, const std::vector<Component*>& components )
+		{
+			using FieldType = std::tuple_element_t<INDEX, std::tuple<Fields ...>>;
+			auto member = std::get<INDEX>( m_members );
+
+			uint8_t* column = frame.m_fields[INDEX].data();
+			for( size_t i = 0; i < frame.m_count; ++i )
+			{
+				const T* component = static_cast<const T*>( components[i] );
+				std::memcpy( column + i * sizeof( FieldType ), &( component->*member ), sizeof( FieldType ) );
+			}
+		}
+
+		template<size_t ... INDEX>
+		void RestoreFields( const FrameColumns& frame, size_t row, T* component, std::index_sequence<INDEX ...> )
+		{
+			( RestoreField<INDEX>( frame, row, component ), ... );
+		}
+
+		template<size_t INDEX>
+		void RestoreField( const FrameColumns& frame, size_t row, T* component )
+		{
+			using FieldType = std::tuple_element_t<INDEX, std::tuple<Fields ...>>;
+			auto member = std::get<INDEX>( m_members );
+
+			std::memcpy( &( component->*member ), frame.m_fields[INDEX].data() + row * sizeof( FieldType ), sizeof( FieldType ) );
+		}
+
+		// Slow path used when components have been added or removed since the frame was saved
+		T* FindOwnedComponent( const std::vector<Component*>& components, EntityId ownerId ) const
+		{
+			for( Component* c : components )
+			{
+				if( c != nullptr && c->GetOwnerEntity() == ownerId )
+				{
+					return static_cast<T*>( c );
+				}
+			}
+			return nullptr;
+		}
+
+	};
+
+
+	/*
+	*	The Rollback Buffer keeps a ring of the last 'n' frames of state, for the registered rollback component types only
+	*	Restoring a frame writes the saved values back into the live components, it does not recreate or destroy entities or components
+	*/
+	class RollbackBuffer
+	{
+		// The columns of all registered rollback component types
+		std::vector<IRollbackColumn*>	m_columns;
+
+		// Number of frames kept in the ring
+		size_t							m_numberOfFrames;
+
+		// The next frame number to be saved, frame numbers only ever increase
+		uint64_t						m_nextFrame;
+
+		// The oldest frame number still held in the ring
+		uint64_t						m_oldestFrame;
+
+		// Component Manager reference
+		class ComponentManager*			m_componentManager;
+
+	public:
+
+		RollbackBuffer( ComponentManager* componentManager, size_t numberOfFrames ) :
+			m_columns(),
+			m_numberOfFrames( numberOfFrames > 0 ? numberOfFrames : 1 ),
+			m_nextFrame( 0 ),
+			m_oldestFrame( 0 ),
+			m_componentManager( componentManager )
+		{}
+
+		~RollbackBuffer()
+		{
+			for( IRollbackColumn* column : m_columns )
+			{
+				delete column, column = nullptr;
+			}
+			m_columns.clear();
+		}
+
+		RollbackBuffer( const RollbackBuffer& ) = delete;
+		RollbackBuffer& operator=( const RollbackBuffer& ) = delete;
+		RollbackBuffer( RollbackBuffer&& ) = delete;
+		RollbackBuffer& operator=( RollbackBuffer&& ) = delete;
+
+		/*
+		*	Registers the component type <T> for rollback, only the passed fields will be saved and restored
+		*	@param	<T>:		The type of Component to save each frame
+		*	@param	Fields:		Member pointers to the fields of <T> that make up its simulation state
+		*/
+		template<typename T, typename ... Fields>
+		void RegisterComponent( Fields T::* ... fields )
+		{
+			for( IRollbackColumn* column : m_columns )
+			{
+				if( column->GetComponentType() == T::ID )	// Already registered
+				{
+					return;
+				}
+			}
+
+			m_columns.push_back( new RollbackColumn<T, Fields ...>( m_numberOfFrames, MAX_ENTITIES, fields ... ) );
+		}
+
+		/*
+		*	Saves the current state of all registered component types into the ring, overwriting the oldest frame when full
+		*	@return	uint64_t:	The frame number the state was saved as
+		*/
+		uint64_t SaveFrame();
+
+		/*
+		*	Restores the state saved for the passed frame number, frames after the restored frame are discarded
+		*	@param	uint64_t:	The frame number to restore
+		*	@return	bool:	Returns true, if the frame was still held in the ring and was restored. Returns false, if otherwise
+		*/
+		bool RestoreFrame( uint64_t frame );
+
+		// Returns true, if the passed frame number is still held in the ring
+		inline bool HasFrame( uint64_t frame ) const
+		{
+			return m_nextFrame > 0 && frame >= m_oldestFrame && frame < m_nextFrame;
+		}
+
+		// Returns the most recently saved frame number
+		inline uint64_t GetLatestFrame() const { return m_nextFrame > 0 ? m_nextFrame - 1 : 0; }
+
+		inline size_t GetNumberOfFrames() const { return m_numberOfFrames; }
+
+	};
+
+}
+
+
+#endif // !ROLLBACK_H
@@ -0,0 +1,220 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#include "ShardedWorld.h"
+
+#include <cmath>
+
+namespace ECS
+{
+
+	ShardedWorld::ShardedWorld( uint32_t shardCount, float regionSize ) :
+		m_shards( shardCount > 0 ? shardCount : 1 ),
+		m_outboxes( m_shards.size() * m_shards.size() ),
+		m_migrations(),
+		m_partition(),
+		m_threads(),
+		m_frame( 0 ),
+		m_pendingShards( 0 ),
+		m_deltaTime( 0.0f ),
+		m_bShutdown( false )
+	{
+		const uint32_t count = GetShardCount();
+		const float inverseRegionSize = 1.0f / ( regionSize > 0.0f ? regionSize : 1.0f );
+
+		m_partition = [count, inverseRegionSize]( const Kobe::Vector3& position )
+		{
+			const int64_t band = static_cast<int64_t>( std::floor( position.x * inverseRegionSize ) );
+			return static_cast<ShardId>( ( ( band % count ) + count ) % count );
+		};
+
+		for( ShardId shardId = 0; shardId < count; ++shardId )
+		{
+			m_shards[shardId].m_world = new World();
+			m_shards[shardId].m_world->SetResource<ShardContext>( ShardContext{ this, shardId } );
+		}
+
+		for( ShardId shardId = 1; shardId < count; ++shardId )
+		{
+			m_threads.emplace_back( &ShardedWorld::WorkerLoop, this, shardId );
+		}
+	}
+
+	ShardedWorld::~ShardedWorld()
+	{
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_bShutdown = true;
+		}
+		m_frameStart.notify_all();
+
+		for( std::thread& thread : m_threads )
+		{
+			thread.join();
+		}
+		m_threads.clear();
+
+		for( Shard& shard : m_shards )
+		{
+			delete shard.m_world, shard.m_world = nullptr;
+		}
+		m_shards.clear();
+	}
+
+	void ShardedWorld::Update( float deltaTime )
+	{
+		ProcessFrameBoundary();
+
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_deltaTime = deltaTime;
+			m_pendingShards = GetShardCount() - 1;
+			++m_frame;
+		}
+		m_frameStart.notify_all();
+
+		UpdateShard( 0 );
+
+		std::unique_lock<std::mutex> lock( m_mutex );
+		m_frameDone.wait( lock, [this]() { return m_pendingShards == 0; } );
+	}
+
+	void ShardedWorld::Send( ShardId fromShard, ShardId toShard, ShardMessage message )
+	{
+		const uint32_t count = GetShardCount();
+		if( fromShard >= count || toShard >= count )
+		{
+			return;
+		}
+
+		m_outboxes[fromShard * count + toShard].push_back( std::move( message ) );
+	}
+
+	void ShardedWorld::Migrate( ShardId fromShard, EntityId entityId, ShardId toShard )
+	{
+		if( fromShard >= GetShardCount() || toShard >= GetShardCount() || fromShard == toShard )
+		{
+			return;
+		}
+
+		m_shards[fromShard].m_migrations.emplace_back( entityId, toShard );
+	}
+
+	ShardId ShardedWorld::MigrateByPosition( ShardId fromShard, EntityId entityId, const Kobe::Vector3& position )
+	{
+		const ShardId toShard = GetShardForPosition( position );
+		if( toShard != fromShard )
+		{
+			Migrate( fromShard, entityId, toShard );
+		}
+		return toShard;
+	}
+
+	void ShardedWorld::WorkerLoop( ShardId shardId )
+	{
+		uint64_t frame = 0;
+		while( true )
+		{
+			{
+				std::unique_lock<std::mutex> lock( m_mutex );
+				m_frameStart.wait( lock, [this, frame]() { return m_bShutdown || m_frame != frame; } );
+				if( m_bShutdown )
+				{
+					return;
+				}
+				frame = m_frame;
+			}
+
+			UpdateShard( shardId );
+
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				if( --m_pendingShards == 0 )
+				{
+					m_frameDone.notify_one();
+				}
+			}
+		}
+	}
+
+	void ShardedWorld::UpdateShard( ShardId shardId )
+	{
+		Shard& shard = m_shards[shardId];
+
+		// Swapped out, so messages sent while running these go out at the next boundary
+		std::vector<ShardMessage> inbox;
+		inbox.swap( shard.m_inbox );
+		for( ShardMessage& message : inbox )
+		{
+			message( *shard.m_world );
+		}
+
+		shard.m_world->Update( m_deltaTime );
+	}
+
+	void ShardedWorld::ProcessFrameBoundary()
+	{
+		const uint32_t count = GetShardCount();
+
+		m_migrations.clear();
+
+		std::vector<EntityId> entities;
+		std::vector<EntityId> remap;
+		for( ShardId fromShard = 0; fromShard < count; ++fromShard )
+		{
+			std::vector<std::pair<EntityId, ShardId>>& requests = m_shards[fromShard].m_migrations;
+			if( requests.empty() )
+			{
+				continue;
+			}
+
+			// One move per target shard, so each pair of shards is merged once
+			for( ShardId toShard = 0; toShard < count; ++toShard )
+			{
+				entities.clear();
+				for( const auto& request : requests )
+				{
+					if( request.second == toShard )
+					{
+						entities.push_back( request.first );
+					}
+				}
+
+				if( entities.empty() )
+				{
+					continue;
+				}
+
+				m_shards[toShard].m_world->MoveEntitiesFrom( *m_shards[fromShard].m_world, entities, &remap );
+				for( EntityId entityId : entities )
+				{
+					if( entityId < remap.size() && remap[entityId] != 0 )
+					{
+						m_migrations.push_back( { fromShard, entityId, toShard, remap[entityId] } );
+						remap[entityId] = 0;	// An entity requested twice is only reported once
+					}
+				}
+			}
+			requests.clear();
+		}
+
+		for( ShardId fromShard = 0; fromShard < count; ++fromShard )
+		{
+			for( ShardId toShard = 0; toShard < count; ++toShard )
+			{
+				std::vector<ShardMessage>& outbox = m_outboxes[fromShard * count + toShard];
+				if( outbox.empty() )
+				{
+					continue;
+				}
+
+				std::vector<ShardMessage>& inbox = m_shards[toShard].m_inbox;
+				for( ShardMessage& message : outbox )
+				{
+					inbox.push_back( std::move( message ) );
+				}
+				outbox.clear();
+			}
+		}
+	}
+
+}
@@ -0,0 +1,165 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef SHARDEDWORLD_H
+#define SHARDEDWORLD_H
+
+#include "ECS_Definitions.h"
+#include "World.h"
+
+#include "../../Math/include/Vector.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ECS
+{
+	using ShardId = uint32_t;
+
+	// A message for another shard, run on the receiving shard's thread at the start of its next update
+	using ShardMessage = std::function<void( World& )>;
+
+	// Maps a position to the shard owning it
+	using ShardPartition = std::function<ShardId( const Kobe::Vector3& )>;
+
+	class ShardedWorld;
+
+	// Set as a resource on every shard, so systems can find their shard and reach the other shards
+	struct ShardContext
+	{
+		ShardedWorld*	m_shardedWorld;
+		ShardId			m_shardId;
+	};
+
+	// An entity moved between shards at the last frame boundary
+	struct ShardMigration
+	{
+		ShardId		m_fromShard;
+		EntityId	m_fromEntity;
+		ShardId		m_toShard;
+		EntityId	m_toEntity;
+	};
+
+	/*
+	*	A world split into independent shards, each its own World, updated in parallel with one thread per shard
+	*	Shards never touch each other during a frame, they interact through messages and entity migration, both applied at the frame boundary
+	*	Every shard runs its own instance of each system, registered with RegisterSystem
+	*/
+	class ShardedWorld
+	{
+		struct Shard
+		{
+			World*						m_world;
+
+			// Messages from other shards, run at the start of this shard's next update
+			std::vector<ShardMessage>	m_inbox;
+
+			// Entities this shard wants moved at the frame boundary, and their target shard
+			std::vector<std::pair<EntityId, ShardId>>	m_migrations;
+		};
+
+		// The shards, indexed by ShardId
+		std::vector<Shard>			m_shards;
+
+		// Messages sent this frame, indexed by from * shardCount + to, each only written by the sending shard's thread
+		std::vector<std::vector<ShardMessage>>	m_outboxes;
+
+		// Entities moved at the last frame boundary
+		std::vector<ShardMigration>	m_migrations;
+
+		// Maps positions to shards, used by GetShardForPosition
+		ShardPartition				m_partition;
+
+		// Worker threads, shard 0 is updated on the thread calling Update
+		std::vector<std::thread>	m_threads;
+
+		std::mutex					m_mutex;
+		std::condition_variable		m_frameStart;
+		std::condition_variable		m_frameDone;
+
+		// Incremented to start a frame on the worker threads
+		uint64_t					m_frame;
+
+		// Worker threads still updating the current frame
+		uint32_t					m_pendingShards;
+
+		// The delta time of the current frame
+		float						m_deltaTime;
+
+		bool						m_bShutdown;
+
+	public:
+
+		/*
+		*	@param	shardCount:		Number of shards, each updated on its own thread
+		*	@param	regionSize:		Width of the bands along X used by the default partition, bands are assigned to shards in turn
+		*/
+		explicit ShardedWorld( uint32_t shardCount, float regionSize = 100.0f );
+		~ShardedWorld();
+
+		ShardedWorld( const ShardedWorld& ) = delete;
+		ShardedWorld& operator=( const ShardedWorld& ) = delete;
+		ShardedWorld( ShardedWorld&& ) = delete;
+		ShardedWorld& operator=( ShardedWorld&& ) = delete;
+
+		/*
+		*	Applies last frame's migrations and messages, then updates every shard in parallel, returning once all shards are done
+		*/
+		void Update( float deltaTime );
+
+		// Registers a separate instance of the system <T> on every shard, constructed with the same arguments
+		template<typename T, typename ... Args>
+		void RegisterSystem( const Args& ... args )
+		{
+			for( Shard& shard : m_shards )
+			{
+				shard.m_world->RegisterSystem<T>( args ... );
+			}
+		}
+
+		/*
+		*	Queues a message for the passed shard, it runs on that shard's thread at the start of its next update
+		*	Call from the sending shard's thread during its update, or from the thread calling Update between frames
+		*/
+		void Send( ShardId fromShard, ShardId toShard, ShardMessage message );
+
+		/*
+		*	Requests that the entity is moved to another shard at the frame boundary, it receives a new EntityId there, see GetMigrations
+		*	An entity that does not fit within the target shard's capacity stays in its shard and is not reported as migrated
+		*	Call from the owning shard's thread during its update, or from the thread calling Update between frames
+		*/
+		void Migrate( ShardId fromShard, EntityId entityId, ShardId toShard );
+
+		// Requests a migration if the passed position belongs to a different shard, returns the shard owning the position
+		ShardId MigrateByPosition( ShardId fromShard, EntityId entityId, const Kobe::Vector3& position );
+
+		// Replaces the default partition along X
+		inline void SetPartition( ShardPartition partition ) { m_partition = std::move( partition ); }
+
+		inline ShardId GetShardForPosition( const Kobe::Vector3& position ) const { return m_partition( position ); }
+
+		inline World* GetShard( ShardId shardId ) const { return m_shards[shardId].m_world; }
+
+		inline uint32_t GetShardCount() const { return static_cast<uint32_t>( m_shards.size() ); }
+
+		// Entities moved at the last frame boundary, used to update handles held outside of the shards
+		inline const std::vector<ShardMigration>& GetMigrations() const { return m_migrations; }
+
+	private:
+
+		void WorkerLoop( ShardId shardId );
+
+		// Runs the shard's inbox, then updates its world
+		void UpdateShard( ShardId shardId );
+
+		// Moves requested entities between shards and hands sent messages to their shards, on the thread calling Update
+		void ProcessFrameBoundary();
+
+	};
+
+}
+
+#endif // !SHARDEDWORLD_H
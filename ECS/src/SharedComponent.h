@@ -0,0 +1,276 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef SHAREDCOMPONENT_H
+#define SHAREDCOMPONENT_H
+
+#include "ECS_Definitions.h"
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace ECS
+{
+	/*
+	*	Interface for the store of a single shared component type
+	*/
+	class ISharedComponentStore
+	{
+	public:
+		ISharedComponentStore() {}
+		virtual ~ISharedComponentStore() {}
+
+		// Releases the entity's reference to its shared value, if it has one
+		virtual void Remove( EntityId entityId ) = 0;
+
+		// Creates an empty store for the same shared component type
+		virtual ISharedComponentStore* CreateEmpty() const = 0;
+
+		/*
+		*	Makes each moved entity reference the value its old entity referenced in the passed store, which must be of the same type
+		*	@param	entities:	The EntityIds, in the source's world, of the entities that may have been moved
+		*	@param	remap:		The EntityId in this store's world of each EntityId in the source's world, 0 for entities that were not moved
+		*/
+		virtual void MergeFrom( const ISharedComponentStore& source, const std::vector<EntityId>& entities, const std::vector<EntityId>& remap ) = 0;
+
+		// Number of distinct values currently referenced
+		virtual size_t GetValueCount() const = 0;
+
+		// Number of value slots, including released slots waiting to be reused
+		virtual size_t GetSlotCount() const = 0;
+	};
+
+
+	/*
+	*	Stores each distinct value of the shared component type <T> once, entities reference a value by its index
+	*	Values are reference counted and released when no entity references them anymore
+	*	<T> is any copyable type with operator==, it does not derive from Component and does not take part in system signatures
+	*/
+	template<typename T>
+	class SharedComponentStore : public ISharedComponentStore
+	{
+		// The distinct values, indexed by shared index, empty slots are free
+		std::vector<std::optional<T>>		m_values;
+
+		// Number of entities referencing each value
+		std::vector<uint32_t>				m_referenceCounts;
+
+		// The entities referencing each value, used to visit entities grouped by value
+		std::vector<std::vector<EntityId>>	m_groups;
+
+		// Shared indices of released values, ready to be reused
+		std::vector<uint32_t>				m_freeIndices;
+
+		// The shared index referenced by each entity, indexed by EntityId
+		std::vector<uint32_t>				m_entityIndex;
+
+		// The position of each entity inside its group, indexed by EntityId
+		std::vector<uint32_t>				m_entityGroupSlot;
+
+	public:
+
+		static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+		SharedComponentStore() :
+			m_entityIndex( MAX_ENTITY_ID + 1, INVALID_INDEX ),
+			m_entityGroupSlot( MAX_ENTITY_ID + 1, 0 )
+		{}
+
+		virtual ~SharedComponentStore() {}
+
+		/*
+		*	Makes the entity reference the passed value, the value is only stored if no equal value already exists
+		*	@return	uint32_t:	The shared index of the value, or INVALID_INDEX if the EntityId is out of range
+		*/
+		uint32_t Set( EntityId entityId, const T& value )
+		{
+			// Checked before the value is stored, so an invalid EntityId can not leave a value without references
+			if( entityId > MAX_ENTITY_ID )
+			{
+				return INVALID_INDEX;
+			}
+
+			uint32_t index = Find( value );
+			if( index == INVALID_INDEX )
+			{
+				index = Insert( value );
+			}
+			return SetIndex( entityId, index );
+		}
+
+		/*
+		*	Makes the entity reference the value at the passed shared index, this avoids comparing values when the index is already known
+		*	@return	uint32_t:	The passed shared index, or INVALID_INDEX if the EntityId or shared index is invalid
+		*/
+		uint32_t SetIndex( EntityId entityId, uint32_t index )
+		{
+			if( entityId > MAX_ENTITY_ID || index >= m_values.size() || !m_values[index].has_value() )
+			{
+				return INVALID_INDEX;
+			}
+
+			if( m_entityIndex[entityId] == index )
+			{
+				return index;
+			}
+
+			// Take the reference first, so re-pointing the last entity of a value to an equal value never releases it
+			++m_referenceCounts[index];
+			Remove( entityId );
+
+			m_entityIndex[entityId] = index;
+			m_entityGroupSlot[entityId] = static_cast<uint32_t>( m_groups[index].size() );
+			m_groups[index].push_back( entityId );
+
+			return index;
+		}
+
+		virtual void Remove( EntityId entityId ) override
+		{
+			if( entityId > MAX_ENTITY_ID || m_entityIndex[entityId] == INVALID_INDEX )
+			{
+				return;
+			}
+
+			const uint32_t index = m_entityIndex[entityId];
+
+			// Swap the last entity of the group into the removed entity's slot
+			std::vector<EntityId>& group = m_groups[index];
+			const uint32_t slot = m_entityGroupSlot[entityId];
+			group[slot] = group.back();
+			m_entityGroupSlot[group[slot]] = slot;
+			group.pop_back();
+
+			m_entityIndex[entityId] = INVALID_INDEX;
+			Release( index );
+		}
+
+		virtual ISharedComponentStore* CreateEmpty() const override
+		{
+			return new SharedComponentStore<T>();
+		}
+
+		virtual void MergeFrom( const ISharedComponentStore& source, const std::vector<EntityId>& entities, const std::vector<EntityId>& remap ) override
+		{
+			const SharedComponentStore<T>& other = static_cast<const SharedComponentStore<T>&>( source );
+
+			// Values are only compared once, the other moved entities sharing a value reuse the found index
+			std::unordered_map<uint32_t, uint32_t> mergedIndices;
+			for( EntityId entityId : entities )
+			{
+				const uint32_t sourceIndex = other.GetIndex( entityId );
+				if( sourceIndex == INVALID_INDEX || entityId >= remap.size() || remap[entityId] == 0 )
+				{
+					continue;
+				}
+
+				auto it = mergedIndices.find( sourceIndex );
+				if( it != mergedIndices.end() )
+				{
+					SetIndex( remap[entityId], it->second );
+				}
+				else
+				{
+					mergedIndices.emplace( sourceIndex, Set( remap[entityId], *other.m_values[sourceIndex] ) );
+				}
+			}
+		}
+
+		// Returns the value referenced by the entity, returning nullptr if it has none
+		inline const T* Get( EntityId entityId ) const
+		{
+			const uint32_t index = GetIndex( entityId );
+			return index != INVALID_INDEX ? &*m_values[index] : nullptr;
+		}
+
+		// Returns the shared index referenced by the entity, returning INVALID_INDEX if it has none
+		inline uint32_t GetIndex( EntityId entityId ) const
+		{
+			return entityId <= MAX_ENTITY_ID ? m_entityIndex[entityId] : INVALID_INDEX;
+		}
+
+		// Returns the value at the passed shared index
+		inline const T& GetValue( uint32_t index ) const
+		{
+			return *m_values[index];
+		}
+
+		// Returns the entities referencing the value at the passed shared index
+		inline const std::vector<EntityId>& GetEntities( uint32_t index ) const
+		{
+			return m_groups[index];
+		}
+
+		virtual size_t GetValueCount() const override
+		{
+			return m_values.size() - m_freeIndices.size();
+		}
+
+		virtual size_t GetSlotCount() const override
+		{
+			return m_values.size();
+		}
+
+		/*
+		*	Calls the passed function once per distinct value, with the value and every entity referencing it
+		*	@param	Function:	Callable taking ( const T&, const std::vector<EntityId>& )
+		*/
+		template<typename Function>
+		void ForEachGroup( Function&& function ) const
+		{
+			const size_t size = m_values.size();
+			for( size_t i = 0; i < size; ++i )
+			{
+				if( m_values[i].has_value() && !m_groups[i].empty() )
+				{
+					function( *m_values[i], m_groups[i] );
+				}
+			}
+		}
+
+	private:
+
+		// Returns the shared index of a value equal to the passed value, returning INVALID_INDEX if there is none
+		uint32_t Find( const T& value ) const
+		{
+			const size_t size = m_values.size();
+			for( size_t i = 0; i < size; ++i )
+			{
+				if( m_values[i].has_value() && *m_values[i] == value )
+				{
+					return static_cast<uint32_t>( i );
+				}
+			}
+			return INVALID_INDEX;
+		}
+
+		uint32_t Insert( const T& value )
+		{
+			if( !m_freeIndices.empty() )
+			{
+				const uint32_t index = m_freeIndices.back();
+				m_freeIndices.pop_back();
+				m_values[index].emplace( value );
+				return index;
+			}
+
+			m_values.emplace_back( value );
+			m_referenceCounts.push_back( 0 );
+			m_groups.emplace_back();
+			return static_cast<uint32_t>( m_values.size() - 1 );
+		}
+
+		void Release( uint32_t index )
+		{
+			if( --m_referenceCounts[index] == 0 )
+			{
+				m_values[index].reset();
+				m_freeIndices.push_back( index );
+			}
+		}
+
+	};
+
+}
+
+#endif // !SHAREDCOMPONENT_H
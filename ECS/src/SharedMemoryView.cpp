@@ -0,0 +1,368 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#include "SharedMemoryView.h"
+#include "ComponentManager.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <new>
+
+namespace ECS
+{
+	namespace
+	{
+		// Column data is aligned so every field can be read in place
+		constexpr uint64_t SHARED_VIEW_ALIGNMENT = 64;
+
+		inline uint64_t AlignUp( uint64_t value, uint64_t alignment )
+		{
+			return ( value + alignment - 1 ) & ~( alignment - 1 );
+		}
+
+		inline uint64_t GetHeaderBytes()
+		{
+			return AlignUp( sizeof( SharedViewHeader ), SHARED_VIEW_ALIGNMENT );
+		}
+
+		inline uint64_t GetFrameHeaderBytes()
+		{
+			return AlignUp( sizeof( SharedViewFrame ), SHARED_VIEW_ALIGNMENT );
+		}
+
+		inline SharedViewFrame* GetFrameAt( void* data, uint64_t frameBytes, uint32_t index )
+		{
+			return reinterpret_cast<SharedViewFrame*>( static_cast<uint8_t*>( data ) + GetHeaderBytes() + index * frameBytes );
+		}
+
+		// POSIX names must start with a single '/', Windows names are used as they are
+		inline std::string GetPlatformName( const std::string& name )
+		{
+#ifdef _WIN32
+			return name;
+#else
+			return !name.empty() && name[0] == '/' ? name : "/" + name;
+#endif
+		}
+	}
+
+	bool SharedMemoryRegion::Create( const std::string& name, size_t size )
+	{
+		Close();
+
+		const std::string platformName = GetPlatformName( name );
+
+#ifdef _WIN32
+		HANDLE mapping = CreateFileMappingA( INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>( static_cast<uint64_t>( size ) >> 32 ), static_cast<DWORD>( size & 0xFFFFFFFFu ), platformName.c_str() );
+		if( mapping == nullptr )
+		{
+			return false;
+		}
+
+		void* data = MapViewOfFile( mapping, FILE_MAP_ALL_ACCESS, 0, 0, size );
+		if( data == nullptr )
+		{
+			CloseHandle( mapping );
+			return false;
+		}
+
+		m_handle = reinterpret_cast<intptr_t>( mapping );
+#else
+		// A region left behind by a crashed publisher is replaced, readers still mapping it keep the old pages
+		shm_unlink( platformName.c_str() );
+
+		const int fd = shm_open( platformName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644 );
+		if( fd < 0 )
+		{
+			return false;
+		}
+
+		if( ftruncate( fd, static_cast<off_t>( size ) ) != 0 )
+		{
+			close( fd );
+			shm_unlink( platformName.c_str() );
+			return false;
+		}
+
+		void* data = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+		if( data == MAP_FAILED )
+		{
+			close( fd );
+			shm_unlink( platformName.c_str() );
+			return false;
+		}
+
+		m_handle = fd;
+#endif
+
+		m_data = data;
+		m_size = size;
+		m_name = platformName;
+		m_bOwner = true;
+		return true;
+	}
+
+	bool SharedMemoryRegion::Open( const std::string& name )
+	{
+		Close();
+
+		const std::string platformName = GetPlatformName( name );
+
+#ifdef _WIN32
+		HANDLE mapping = OpenFileMappingA( FILE_MAP_READ, FALSE, platformName.c_str() );
+		if( mapping == nullptr )
+		{
+			return false;
+		}
+
+		void* data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+		if( data == nullptr )
+		{
+			CloseHandle( mapping );
+			return false;
+		}
+
+		MEMORY_BASIC_INFORMATION info = {};
+		VirtualQuery( data, &info, sizeof( info ) );
+
+		m_handle = reinterpret_cast<intptr_t>( mapping );
+		m_size = info.RegionSize;
+#else
+		const int fd = shm_open( platformName.c_str(), O_RDONLY, 0 );
+		if( fd < 0 )
+		{
+			return false;
+		}
+
+		struct stat status = {};
+		if( fstat( fd, &status ) != 0 || status.st_size <= 0 )
+		{
+			close( fd );
+			return false;
+		}
+
+		void* data = mmap( nullptr, static_cast<size_t>( status.st_size ), PROT_READ, MAP_SHARED, fd, 0 );
+		if( data == MAP_FAILED )
+		{
+			close( fd );
+			return false;
+		}
+
+		m_handle = fd;
+		m_size = static_cast<size_t>( status.st_size );
+#endif
+
+		m_data = data;
+		m_name = platformName;
+		m_bOwner = false;
+		return true;
+	}
+
+	void SharedMemoryRegion::Close()
+	{
+		if( m_data == nullptr )
+		{
+			return;
+		}
+
+#ifdef _WIN32
+		UnmapViewOfFile( m_data );
+		CloseHandle( reinterpret_cast<HANDLE>( m_handle ) );
+#else
+		munmap( m_data, m_size );
+		close( static_cast<int>( m_handle ) );
+		if( m_bOwner )
+		{
+			shm_unlink( m_name.c_str() );
+		}
+#endif
+
+		m_data = nullptr;
+		m_size = 0;
+		m_handle = -1;
+		m_name.clear();
+		m_bOwner = false;
+	}
+
+
+	SharedMemoryPublisher::SharedMemoryPublisher( ComponentManager* componentManager, const std::string& name, size_t frameBytes ) :
+		m_columns(),
+		m_region(),
+		m_frame( 0 ),
+		m_updateCount( 0 ),
+		m_publishInterval( 1 ),
+		m_componentManager( componentManager )
+	{
+		const uint64_t alignedFrameBytes = AlignUp( std::max<uint64_t>( frameBytes, GetFrameHeaderBytes() ), SHARED_VIEW_ALIGNMENT );
+		if( !m_region.Create( name, static_cast<size_t>( GetHeaderBytes() + 2 * alignedFrameBytes ) ) )
+		{
+			return;
+		}
+
+		// The region is zero filled, so both frames start with an even sequence and no tables
+		SharedViewHeader* header = new ( m_region.GetData() ) SharedViewHeader();
+		header->m_version = SHARED_VIEW_VERSION;
+		header->m_frameBytes = alignedFrameBytes;
+		header->m_latest.store( 0, std::memory_order_relaxed );
+		for( uint32_t i = 0; i < 2; ++i )
+		{
+			new ( GetFrameAt( m_region.GetData(), alignedFrameBytes, i ) ) SharedViewFrame();
+		}
+
+		// Written last, readers ignore the region until the magic is in place
+		std::atomic_thread_fence( std::memory_order_release );
+		header->m_magic = SHARED_VIEW_MAGIC;
+	}
+
+	SharedMemoryPublisher::~SharedMemoryPublisher()
+	{
+		for( ISharedViewColumn* column : m_columns )
+		{
+			delete column, column = nullptr;
+		}
+		m_columns.clear();
+
+		m_region.Close();
+	}
+
+	bool SharedMemoryPublisher::Publish()
+	{
+		if( !m_region.IsOpen() )
+		{
+			return false;
+		}
+
+		SharedViewHeader* header = static_cast<SharedViewHeader*>( m_region.GetData() );
+		const uint64_t frameBytes = header->m_frameBytes;
+
+		// Readers are directed at the latest frame, so the other one is rewritten
+		const uint32_t index = header->m_latest.load( std::memory_order_relaxed ) ^ 1;
+		SharedViewFrame* frame = GetFrameAt( m_region.GetData(), frameBytes, index );
+		uint8_t* base = reinterpret_cast<uint8_t*>( frame );
+
+		// Odd while writing, a reader that started before this sees the change and retries
+		const uint64_t sequence = frame->m_sequence.load( std::memory_order_relaxed );
+		frame->m_sequence.store( sequence + 1, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_release );
+
+		uint64_t offset = GetFrameHeaderBytes();
+		uint32_t tableCount = 0;
+		bool bTruncated = false;
+
+		uint8_t* fields[SHARED_VIEW_MAX_FIELDS] = {};
+		for( ISharedViewColumn* column : m_columns )
+		{
+			const std::vector<Component*>& components = m_componentManager->GetComponentsOfType( column->GetComponentType() );
+			const uint32_t fieldCount = column->GetFieldCount();
+
+			uint64_t rowBytes = sizeof( EntityId );
+			for( uint32_t i = 0; i < fieldCount; ++i )
+			{
+				rowBytes += column->GetFieldSize( i );
+			}
+
+			// Each column is aligned separately, reserve for the worst case padding of every column
+			const uint64_t paddingBytes = ( fieldCount + 1 ) * SHARED_VIEW_ALIGNMENT;
+			const uint64_t available = frameBytes > offset + paddingBytes ? frameBytes - offset - paddingBytes : 0;
+
+			size_t count = components.size();
+			if( count * rowBytes > available )
+			{
+				count = static_cast<size_t>( available / rowBytes );
+				bTruncated = true;
+			}
+
+			SharedViewTable& table = frame->m_tables[tableCount++];
+			table.m_componentType = column->GetComponentType();
+			table.m_count = static_cast<uint32_t>( count );
+			table.m_fieldCount = fieldCount;
+
+			table.m_ownersOffset = offset;
+			offset = AlignUp( offset + count * sizeof( EntityId ), SHARED_VIEW_ALIGNMENT );
+
+			for( uint32_t i = 0; i < fieldCount; ++i )
+			{
+				table.m_fieldOffsets[i] = offset;
+				table.m_fieldSizes[i] = column->GetFieldSize( i );
+				fields[i] = base + offset;
+				offset = AlignUp( offset + count * table.m_fieldSizes[i], SHARED_VIEW_ALIGNMENT );
+			}
+
+			column->Write( components, count, reinterpret_cast<EntityId*>( base + table.m_ownersOffset ), fields );
+		}
+
+		frame->m_frame = m_frame;
+		frame->m_tableCount = tableCount;
+		frame->m_bTruncated = bTruncated ? 1 : 0;
+		frame->m_usedBytes = offset - GetFrameHeaderBytes();
+
+		frame->m_sequence.store( sequence + 2, std::memory_order_release );
+		header->m_latest.store( index, std::memory_order_release );
+
+		++m_frame;
+		return true;
+	}
+
+
+	bool SharedMemoryReader::Open( const std::string& name )
+	{
+		if( !m_region.Open( name ) )
+		{
+			return false;
+		}
+
+		const SharedViewHeader* header = static_cast<const SharedViewHeader*>( m_region.GetData() );
+		const bool bValid = m_region.GetSize() >= GetHeaderBytes()
+			&& header->m_magic == SHARED_VIEW_MAGIC
+			&& header->m_version == SHARED_VIEW_VERSION
+			&& GetHeaderBytes() + 2 * header->m_frameBytes <= m_region.GetSize();
+
+		if( !bValid )
+		{
+			m_region.Close();
+			return false;
+		}
+
+		std::atomic_thread_fence( std::memory_order_acquire );
+		return true;
+	}
+
+	const SharedViewFrame* SharedMemoryReader::BeginRead( uint64_t& sequence ) const
+	{
+		if( !m_region.IsOpen() )
+		{
+			return nullptr;
+		}
+
+		const SharedViewHeader* header = static_cast<const SharedViewHeader*>( m_region.GetData() );
+		const uint32_t index = header->m_latest.load( std::memory_order_acquire ) & 1;
+		const SharedViewFrame* frame = GetFrameAt( m_region.GetData(), header->m_frameBytes, index );
+
+		sequence = frame->m_sequence.load( std::memory_order_acquire );
+		if( sequence == 0 )	// Nothing has been published yet
+		{
+			return nullptr;
+		}
+
+		// An odd sequence means the publisher has lapped the reader and is rewriting this frame, EndRead fails for it
+		return frame;
+	}
+
+	bool SharedMemoryReader::EndRead( const SharedViewFrame* frame, uint64_t sequence ) const
+	{
+		// Orders the reads of the frame data before the second read of the sequence
+		std::atomic_thread_fence( std::memory_order_acquire );
+		return ( sequence & 1 ) == 0 && frame->m_sequence.load( std::memory_order_relaxed ) == sequence;
+	}
+
+}
@@ -0,0 +1,407 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef SHAREDMEMORYVIEW_H
+#define SHAREDMEMORYVIEW_H
+
+#include "ECS_Definitions.h"
+#include "Component.h"
+#include "Utility/TemplateHelper.h"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ECS
+{
+	// Maximum number of component types and fields per type a shared memory view can publish
+	static constexpr uint32_t SHARED_VIEW_MAX_TABLES { 64 };
+	static constexpr uint32_t SHARED_VIEW_MAX_FIELDS { 16 };
+
+	// Identifies a shared memory view region, changed whenever the layout below changes
+	static constexpr uint64_t SHARED_VIEW_MAGIC { 0x5745495645534345ull };
+	static constexpr uint32_t SHARED_VIEW_VERSION { 1 };
+
+	static_assert( std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free, "Shared memory views need lock-free atomics, as they are shared between processes" );
+
+	/*
+	*	The published columns of a single component type, inside of a SharedViewFrame
+	*	Offsets are in bytes from the start of the frame
+	*/
+	struct SharedViewTable
+	{
+		uint64_t	m_componentType;
+		uint32_t	m_count;
+		uint32_t	m_fieldCount;
+
+		// The owning entity of each row, EntityId[m_count]
+		uint64_t	m_ownersOffset;
+
+		// One tightly packed column per field, in registration order
+		uint64_t	m_fieldOffsets[SHARED_VIEW_MAX_FIELDS];
+		uint32_t	m_fieldSizes[SHARED_VIEW_MAX_FIELDS];
+	};
+
+	/*
+	*	A single published frame, followed in memory by the column data
+	*	m_sequence is a seqlock: odd while the publisher writes the frame, and changed by every publish
+	*/
+	struct SharedViewFrame
+	{
+		std::atomic<uint64_t>	m_sequence;
+
+		// The number of frames published before this one, the World update number when publishing after every update
+		uint64_t				m_frame;
+
+		uint32_t				m_tableCount;
+
+		// Set if the frame ran out of space, and some rows or tables are missing
+		uint32_t				m_bTruncated;
+
+		// Bytes of column data used after the frame header
+		uint64_t				m_usedBytes;
+
+		SharedViewTable			m_tables[SHARED_VIEW_MAX_TABLES];
+
+		// Returns the table of the passed component type, nullptr if it is not published
+		const SharedViewTable* FindTable( uint64_t componentType ) const
+		{
+			for( uint32_t i = 0; i < m_tableCount && i < SHARED_VIEW_MAX_TABLES; ++i )
+			{
+				if( m_tables[i].m_componentType == componentType )
+				{
+					return &m_tables[i];
+				}
+			}
+			return nullptr;
+		}
+
+		inline const EntityId* GetOwners( const SharedViewTable& table ) const
+		{
+			return reinterpret_cast<const EntityId*>( reinterpret_cast<const uint8_t*>( this ) + table.m_ownersOffset );
+		}
+
+		// Returns the column of the field at the passed registration index, the field type must match the registered one
+		template<typename FieldType>
+		const FieldType* GetField( const SharedViewTable& table, uint32_t fieldIndex ) const
+		{
+			if( fieldIndex >= table.m_fieldCount || table.m_fieldSizes[fieldIndex] != sizeof( FieldType ) )
+			{
+				return nullptr;
+			}
+			return reinterpret_cast<const FieldType*>( reinterpret_cast<const uint8_t*>( this ) + table.m_fieldOffsets[fieldIndex] );
+		}
+	};
+
+	// Placed at the start of the region, followed by two frames of m_frameBytes each
+	struct SharedViewHeader
+	{
+		uint64_t				m_magic;
+		uint32_t				m_version;
+		uint32_t				m_padding;
+
+		// Size of each frame, header included
+		uint64_t				m_frameBytes;
+
+		// Index of the most recently completed frame, readers start from it
+		std::atomic<uint32_t>	m_latest;
+	};
+
+
+	/*
+	*	A named shared memory mapping, POSIX shm_open on Linux and macOS, a named file mapping on Windows
+	*/
+	class SharedMemoryRegion
+	{
+		void*		m_data;
+		size_t		m_size;
+
+		// The file descriptor or HANDLE of the mapping
+		intptr_t	m_handle;
+
+		std::string	m_name;
+
+		// Set for the creating side, which removes the name again on Close
+		bool		m_bOwner;
+
+	public:
+
+		SharedMemoryRegion() :
+			m_data( nullptr ),
+			m_size( 0 ),
+			m_handle( -1 ),
+			m_name(),
+			m_bOwner( false )
+		{}
+
+		~SharedMemoryRegion()
+		{
+			Close();
+		}
+
+		SharedMemoryRegion( const SharedMemoryRegion& ) = delete;
+		SharedMemoryRegion& operator=( const SharedMemoryRegion& ) = delete;
+		SharedMemoryRegion( SharedMemoryRegion&& ) = delete;
+		SharedMemoryRegion& operator=( SharedMemoryRegion&& ) = delete;
+
+		// Creates, or recreates, the named region with the passed size, mapped for writing
+		bool Create( const std::string& name, size_t size );
+
+		// Maps an existing named region for reading
+		bool Open( const std::string& name );
+
+		void Close();
+
+		inline void* GetData() const { return m_data; }
+		inline size_t GetSize() const { return m_size; }
+		inline bool IsOpen() const { return m_data != nullptr; }
+	};
+
+
+	/*
+	*	Interface for a published column set, copying the registered fields of one component type into a frame
+	*/
+	class ISharedViewColumn
+	{
+	public:
+		ISharedViewColumn() {}
+		virtual ~ISharedViewColumn() {}
+
+		virtual uint64_t GetComponentType() const = 0;
+
+		virtual uint32_t GetFieldCount() const = 0;
+
+		virtual uint32_t GetFieldSize( uint32_t fieldIndex ) const = 0;
+
+		// Copies the registered fields of the first 'count' components into the passed columns
+		virtual void Write( const std::vector<Component*>& components, size_t count, EntityId* owners, uint8_t* const* fields ) const = 0;
+	};
+
+
+	/*
+	*	Published columns for the component type <T>, only the fields passed as member pointers are published
+	*/
+	template<typename T, typename ... Fields>
+	class SharedViewColumn : public ISharedViewColumn
+	{
+		static constexpr uint32_t NUM_FIELDS = static_cast<uint32_t>( sizeof...( Fields ) );
+
+		// The member pointers for the fields that are published
+		std::tuple<Fields T::* ...>		m_members;
+
+	public:
+
+		explicit SharedViewColumn( Fields T::* ... members ) :
+			m_members( members ... )
+		{
+			// Complile-time check to see if class T can be converted to class B,
+				// valid for derivation check of class T from class B
+			CanConvert_From<T, Component>();
+
+			static_assert( NUM_FIELDS <= SHARED_VIEW_MAX_FIELDS, "Too many published fields for a single component type" );
+			static_assert( ( std::is_trivially_copyable_v<Fields> && ... ), "Published fields must be plain data, readers in other processes only see their bytes" );
+		}
+
+		virtual ~SharedViewColumn() {}
+
+		virtual uint64_t GetComponentType() const override { return T::ID; }
+
+		virtual uint32_t GetFieldCount() const override { return NUM_FIELDS; }
+
+		virtual uint32_t GetFieldSize( uint32_t fieldIndex ) const override
+		{
+			static constexpr uint32_t SIZES[] = { static_cast<uint32_t>( sizeof( Fields ) ) ..., 0 };
+			return fieldIndex < NUM_FIELDS ? SIZES[fieldIndex] : 0;
+		}
+
+		virtual void Write( const std::vector<Component*>& components, size_t count, EntityId* owners, uint8_t* const* fields ) const override
+		{
+			for( size_t i = 0; i < count; ++i )
+			{
+				owners[i] = components[i]->GetOwnerEntity();
+			}
+
+			WriteFields( components, count, fields, std::index_sequence_for<Fields ...>() );
+		}
+
+	private:
+
+		template<size_t ... INDEX>
+		void WriteFields( const std::vector<Component*>& components, size_t count, uint8_t* const* fields, std::index_sequence<INDEX ...> ) const
+		{
+			( WriteField<INDEX>( components, count, fields[INDEX] ), ... );
+		}
+
+		// Gathers a single field of every component into its column
+		template<size_t INDEX>
+		void WriteField( const std::vector<Component*>& components, size_t count, uint8_t* column ) const
+		{
+			using FieldType = std::tuple_element_t<INDEX, std::tuple<Fields ...>>;
+			auto member = std::get<INDEX>( m_members );
+
+			for( size_t i = 0; i < count; ++i )
+			{
+				const T* component = static_cast<const T*>( components[i] );
+				std::memcpy( column + i * sizeof( FieldType ), &( component->*member ), sizeof( FieldType ) );
+			}
+		}
+
+	};
+
+
+	/*
+	*	Publishes the registered component fields of a World into a named shared memory region, so external processes can inspect it live
+	*	The region holds two frames, each publish writes the frame readers are not directed to and then points them at it
+	*	Each frame is guarded by a seqlock, so readers never block the publisher, they detect a frame that was rewritten under them and retry
+	*	Cost: each publish copies every registered field of every component of the registered types, whether or not a reader is attached,
+	*	as readers map the region read-only and can not be detected. Use SetPublishInterval to publish every few updates instead
+	*/
+	class SharedMemoryPublisher
+	{
+		// The columns of all registered component types
+		std::vector<ISharedViewColumn*>	m_columns;
+
+		SharedMemoryRegion				m_region;
+
+		// Number of publishes so far
+		uint64_t						m_frame;
+
+		// Number of World updates so far
+		uint64_t						m_updateCount;
+
+		// World updates between publishes
+		uint32_t						m_publishInterval;
+
+		class ComponentManager*			m_componentManager;
+
+	public:
+
+		/*
+		*	@param	name:		The name of the region, e.g. "/ecs_world", a leading '/' is added if missing
+		*	@param	frameBytes:	Bytes reserved for each of the two frames, data past this is left out and the frame is marked as truncated
+		*/
+		SharedMemoryPublisher( ComponentManager* componentManager, const std::string& name, size_t frameBytes );
+		~SharedMemoryPublisher();
+
+		SharedMemoryPublisher( const SharedMemoryPublisher& ) = delete;
+		SharedMemoryPublisher& operator=( const SharedMemoryPublisher& ) = delete;
+		SharedMemoryPublisher( SharedMemoryPublisher&& ) = delete;
+		SharedMemoryPublisher& operator=( SharedMemoryPublisher&& ) = delete;
+
+		/*
+		*	Registers the component type <T> for publishing, only the passed fields are published, in the passed order
+		*	@param	<T>:		The type of Component to publish
+		*	@param	Fields:		Member pointers to the fields of <T> that readers can see
+		*/
+		template<typename T, typename ... Fields>
+		void RegisterComponent( Fields T::* ... fields )
+		{
+			if( m_columns.size() >= SHARED_VIEW_MAX_TABLES )
+			{
+				return;
+			}
+
+			for( ISharedViewColumn* column : m_columns )
+			{
+				if( column->GetComponentType() == T::ID )	// Already registered
+				{
+					return;
+				}
+			}
+
+			m_columns.push_back( new SharedViewColumn<T, Fields ...>( fields ... ) );
+		}
+
+		// Copies the registered fields into the back frame and makes it the latest, returning false if the region could not be created
+		bool Publish();
+
+		// Called by the World after each Update, publishing once every publish interval
+		inline void OnWorldUpdated()
+		{
+			if( m_updateCount++ % m_publishInterval == 0 )
+			{
+				Publish();
+			}
+		}
+
+		// Publishes once every 'updates' World updates, 1 publishes after every update
+		inline void SetPublishInterval( uint32_t updates ) { m_publishInterval = updates > 0 ? updates : 1; }
+
+		inline uint32_t GetPublishInterval() const { return m_publishInterval; }
+
+		inline bool IsOpen() const { return m_region.IsOpen(); }
+
+		inline uint64_t GetFrame() const { return m_frame; }
+
+	};
+
+
+	/*
+	*	Reads the frames published by a SharedMemoryPublisher, usually in another process
+	*	Reads are zero-copy: the frame is read in place, then validated. Data read from a frame that failed validation must be discarded
+	*/
+	class SharedMemoryReader
+	{
+		SharedMemoryRegion				m_region;
+
+	public:
+
+		SharedMemoryReader() {}
+		~SharedMemoryReader() {}
+
+		SharedMemoryReader( const SharedMemoryReader& ) = delete;
+		SharedMemoryReader& operator=( const SharedMemoryReader& ) = delete;
+		SharedMemoryReader( SharedMemoryReader&& ) = delete;
+		SharedMemoryReader& operator=( SharedMemoryReader&& ) = delete;
+
+		// Maps the named region, returning false if it does not exist or was not created by a SharedMemoryPublisher
+		bool Open( const std::string& name );
+
+		inline void Close() { m_region.Close(); }
+
+		inline bool IsOpen() const { return m_region.IsOpen(); }
+
+		/*
+		*	Returns the latest completed frame, nullptr if none has been published yet
+		*	@param	sequence:	Receives the frame's sequence, to be passed to EndRead
+		*/
+		const SharedViewFrame* BeginRead( uint64_t& sequence ) const;
+
+		// Returns true, if the frame was not rewritten since BeginRead, and everything read from it is consistent
+		bool EndRead( const SharedViewFrame* frame, uint64_t sequence ) const;
+
+		/*
+		*	Calls 'read' with the latest frame until it reads a consistent frame, or runs out of attempts
+		*	'read' may see torn data on a failed attempt, so it should only copy or accumulate, and must bounds check offsets it follows
+		*	@return	bool:	Returns true, if 'read' was called on a frame that validated
+		*/
+		template<typename Function>
+		bool Read( Function&& read, uint32_t maxAttempts = 16 ) const
+		{
+			for( uint32_t attempt = 0; attempt < maxAttempts; ++attempt )
+			{
+				uint64_t sequence = 0;
+				const SharedViewFrame* frame = BeginRead( sequence );
+				if( frame == nullptr )
+				{
+					return false;
+				}
+
+				read( *frame );
+
+				if( EndRead( frame, sequence ) )
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+	};
+
+}
+
+#endif // !SHAREDMEMORYVIEW_H
@@ -0,0 +1,281 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#include "SpatialGrid.h"
+#include "World.h"
+
+#include <cmath>
+
+namespace ECS
+{
+
+	SpatialHashGrid::SpatialHashGrid( float cellSize ) :
+		m_cellSize( cellSize > 0.0f ? cellSize : 1.0f ),
+		m_inverseCellSize( 1.0f / m_cellSize ),
+		m_cells(),
+		m_positions( MAX_ENTITY_ID + 1 ),
+		m_cellKeys( MAX_ENTITY_ID + 1, 0 ),
+		m_cellSlots( MAX_ENTITY_ID + 1, 0 ),
+		m_bInGrid( MAX_ENTITY_ID + 1, 0 ),
+		m_count( 0 )
+	{}
+
+	bool SpatialHashGrid::Update( EntityId entityId, const Kobe::Vector3& position )
+	{
+		if( entityId > MAX_ENTITY_ID )
+		{
+			return false;
+		}
+
+		m_positions[entityId] = position;
+
+		const uint64_t key = MakeCellKey( ToCell( position.x ), ToCell( position.y ), ToCell( position.z ) );
+		if( m_bInGrid[entityId] )
+		{
+			if( m_cellKeys[entityId] == key )	// Still inside of the same cell
+			{
+				return true;
+			}
+			RemoveFromCell( entityId );
+		}
+		else
+		{
+			m_bInGrid[entityId] = 1;
+			++m_count;
+		}
+
+		Cell& cell = m_cells[key];
+		m_cellKeys[entityId] = key;
+		m_cellSlots[entityId] = static_cast<uint32_t>( cell.size() );
+		cell.push_back( entityId );
+
+		return true;
+	}
+
+	void SpatialHashGrid::Remove( EntityId entityId )
+	{
+		if( !Contains( entityId ) )
+		{
+			return;
+		}
+
+		RemoveFromCell( entityId );
+		m_bInGrid[entityId] = 0;
+		--m_count;
+	}
+
+	void SpatialHashGrid::Clear()
+	{
+		for( auto& pair : m_cells )
+		{
+			for( EntityId entityId : pair.second )
+			{
+				m_bInGrid[entityId] = 0;
+			}
+		}
+		m_cells.clear();
+		m_count = 0;
+	}
+
+	size_t SpatialHashGrid::QueryRadius( const Kobe::Vector3& center, float radius, std::vector<EntityId>& result ) const
+	{
+		const float radiusSquared = radius * radius;
+		const Kobe::Vector3 extent( radius );
+
+		return Query( center - extent, center + extent, result, [&]( const Kobe::Vector3& p )
+		{
+			const float dx = p.x - center.x;
+			const float dy = p.y - center.y;
+			const float dz = p.z - center.z;
+			return dx * dx + dy * dy + dz * dz <= radiusSquared;
+		} );
+	}
+
+	size_t SpatialHashGrid::QueryAABB( const Kobe::Vector3& min, const Kobe::Vector3& max, std::vector<EntityId>& result ) const
+	{
+		return Query( min, max, result, [&]( const Kobe::Vector3& p )
+		{
+			return p.x >= min.x && p.y >= min.y && p.z >= min.z
+				&& p.x <= max.x && p.y <= max.y && p.z <= max.z;
+		} );
+	}
+
+	inline int32_t SpatialHashGrid::ToCell( float value ) const
+	{
+		return static_cast<int32_t>( std::floor( value * m_inverseCellSize ) );
+	}
+
+	template<typename Filter>
+	size_t SpatialHashGrid::Query( const Kobe::Vector3& min, const Kobe::Vector3& max, std::vector<EntityId>& result, Filter&& filter ) const
+	{
+		const size_t start = result.size();
+
+		const int32_t minX = ToCell( min.x ), minY = ToCell( min.y ), minZ = ToCell( min.z );
+		const int32_t maxX = ToCell( max.x ), maxY = ToCell( max.y ), maxZ = ToCell( max.z );
+
+		const uint64_t rangeCellCount = uint64_t( maxX - minX + 1 ) * uint64_t( maxY - minY + 1 ) * uint64_t( maxZ - minZ + 1 );
+
+		if( rangeCellCount > m_cells.size() )
+		{
+			// The box covers more cells than are occupied, walking the occupied cells is cheaper
+			for( const auto& pair : m_cells )
+			{
+				for( EntityId entityId : pair.second )
+				{
+					if( filter( m_positions[entityId] ) )
+					{
+						result.push_back( entityId );
+					}
+				}
+			}
+			return result.size() - start;
+		}
+
+		for( int32_t z = minZ; z <= maxZ; ++z )
+		{
+			for( int32_t y = minY; y <= maxY; ++y )
+			{
+				for( int32_t x = minX; x <= maxX; ++x )
+				{
+					auto it = m_cells.find( MakeCellKey( x, y, z ) );
+					if( it == m_cells.end() )
+					{
+						continue;
+					}
+
+					for( EntityId entityId : it->second )
+					{
+						if( filter( m_positions[entityId] ) )
+						{
+							result.push_back( entityId );
+						}
+					}
+				}
+			}
+		}
+
+		return result.size() - start;
+	}
+
+	void SpatialHashGrid::RemoveFromCell( EntityId entityId )
+	{
+		auto it = m_cells.find( m_cellKeys[entityId] );
+		if( it == m_cells.end() )
+		{
+			return;
+		}
+
+		// Swap the last entity of the cell into the removed entity's slot
+		Cell& cell = it->second;
+		const uint32_t slot = m_cellSlots[entityId];
+		cell[slot] = cell.back();
+		m_cellSlots[cell[slot]] = slot;
+		cell.pop_back();
+
+		if( cell.empty() )
+		{
+			m_cells.erase( it );
+		}
+	}
+
+
+	void SpatialGridSystem::Update( float /*deltaTime*/ )
+	{
+		// World transforms are only written by the TransformSystem, without one they never change after being added
+		TransformSystem* transformSystem = GetWorld()->GetSystem<TransformSystem>();
+		const uint64_t transformUpdateCount = transformSystem != nullptr ? transformSystem->GetUpdateCount() : m_transformUpdateCount;
+
+		if( transformUpdateCount > m_transformUpdateCount + 1 )
+		{
+			// Missed the moved entities of an update, so every transform is read again
+			for( Transform* transform : m_transforms )
+			{
+				UpdateEntity( transform->GetOwnerEntity() );
+			}
+		}
+		else
+		{
+			if( transformUpdateCount == m_transformUpdateCount + 1 )
+			{
+				for( EntityId entityId : transformSystem->GetMovedEntities() )
+				{
+					UpdateEntity( entityId );
+				}
+			}
+
+			for( EntityId entityId : m_addedEntities )
+			{
+				UpdateEntity( entityId );
+			}
+		}
+
+		m_addedEntities.clear();
+		m_transformUpdateCount = transformUpdateCount;
+	}
+
+	void SpatialGridSystem::UpdateEntity( EntityId entityId )
+	{
+		const uint32_t index = entityId <= MAX_ENTITY_ID ? m_trackedIndex[entityId] : NOT_TRACKED;
+		if( index == NOT_TRACKED )	// The transform was removed since it moved
+		{
+			return;
+		}
+
+		const Kobe::Matrix4& world = m_transforms[index]->GetWorld();
+		m_grid.Update( entityId, Kobe::Vector3( world[12], world[13], world[14] ) );
+	}
+
+	void SpatialGridSystem::OnEntitySignatureChanged( const Entity& entity )
+	{
+		const EntityId entityId = entity.GetId();
+		if( entityId > MAX_ENTITY_ID )
+		{
+			return;
+		}
+
+		Transform* transform = nullptr;
+		for( auto* c : entity.GetComponents() )	// For all the components on the entity
+		{
+			if( c == nullptr )	// The moment we find a null component, we now we are at the end of the array, no need to continue
+			{
+				break;
+			}
+
+			if( c->GetComponentType() == Transform::ID )
+			{
+				transform = static_cast<Transform*>( c );
+				break;
+			}
+		}
+
+		const uint32_t index = m_trackedIndex[entityId];
+		if( transform != nullptr )
+		{
+			if( index == NOT_TRACKED )
+			{
+				m_trackedIndex[entityId] = static_cast<uint32_t>( m_transforms.size() );
+				m_transforms.push_back( transform );
+				m_addedEntities.push_back( entityId );
+			}
+			else if( m_transforms[index] != transform )
+			{
+				m_transforms[index] = transform;
+				m_addedEntities.push_back( entityId );
+			}
+			return;
+		}
+
+		if( index == NOT_TRACKED )
+		{
+			return;
+		}
+
+		// Swap the last tracked transform into the removed entity's place
+		m_transforms[index] = m_transforms.back();
+		m_trackedIndex[m_transforms[index]->GetOwnerEntity()] = index;
+		m_transforms.pop_back();
+		m_trackedIndex[entityId] = NOT_TRACKED;
+
+		m_grid.Remove( entityId );
+	}
+
+}
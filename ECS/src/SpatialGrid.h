@@ -0,0 +1,193 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include "ECS_Definitions.h"
+#include "Entity.h"
+#include "ISystem.h"
+#include "Transform.h"
+
+#include "../../Math/include/Vector.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ECS
+{
+	/*
+	*	Uniform spatial hash grid of entity positions
+	*	Space is split into cubic cells of equal size, only cells holding entities are stored, keyed by a hash of the cell coordinates
+	*	Moving an entity only touches the cell vectors when it crosses into a different cell
+	*/
+	class SpatialHashGrid
+	{
+		// Entities inside of a single cell
+		using Cell = std::vector<EntityId>;
+
+		// Side length of a cell
+		float							m_cellSize;
+
+		// 1 / m_cellSize
+		float							m_inverseCellSize;
+
+		// The occupied cells, keyed by their packed cell coordinates
+		std::unordered_map<uint64_t, Cell>	m_cells;
+
+		// The last position of each entity, indexed by EntityId
+		std::vector<Kobe::Vector3>		m_positions;
+
+		// The cell key of each entity, indexed by EntityId
+		std::vector<uint64_t>			m_cellKeys;
+
+		// The position of each entity inside of its cell, indexed by EntityId
+		std::vector<uint32_t>			m_cellSlots;
+
+		// Whether each entity is in the grid, indexed by EntityId
+		std::vector<uint8_t>			m_bInGrid;
+
+		// Number of entities in the grid
+		size_t							m_count;
+
+	public:
+
+		/*
+		*	@param	cellSize:	Side length of a cell, about the most common query radius works well
+		*/
+		explicit SpatialHashGrid( float cellSize );
+		~SpatialHashGrid() {}
+
+		SpatialHashGrid( const SpatialHashGrid& ) = delete;
+		SpatialHashGrid& operator=( const SpatialHashGrid& ) = delete;
+		SpatialHashGrid( SpatialHashGrid&& ) = delete;
+		SpatialHashGrid& operator=( SpatialHashGrid&& ) = delete;
+
+		/*
+		*	Inserts the entity at the passed position, or moves it there if it is already in the grid
+		*	@return	bool:	Returns false, if the EntityId is out of range
+		*/
+		bool Update( EntityId entityId, const Kobe::Vector3& position );
+
+		// Removes the entity from the grid, if it is in it
+		void Remove( EntityId entityId );
+
+		// Removes every entity from the grid
+		void Clear();
+
+		/*
+		*	Appends every entity within the passed radius of the center to the result
+		*	@return	size_t:		The number of entities appended
+		*/
+		size_t QueryRadius( const Kobe::Vector3& center, float radius, std::vector<EntityId>& result ) const;
+
+		/*
+		*	Appends every entity inside of the passed axis aligned box to the result
+		*	@return	size_t:		The number of entities appended
+		*/
+		size_t QueryAABB( const Kobe::Vector3& min, const Kobe::Vector3& max, std::vector<EntityId>& result ) const;
+
+		inline bool Contains( EntityId entityId ) const
+		{
+			return entityId <= MAX_ENTITY_ID && m_bInGrid[entityId] != 0;
+		}
+
+		// Returns the last position the entity was updated with
+		inline const Kobe::Vector3& GetPosition( EntityId entityId ) const
+		{
+			return m_positions[entityId <= MAX_ENTITY_ID ? entityId : 0];
+		}
+
+		inline float GetCellSize() const { return m_cellSize; }
+
+		inline size_t GetCount() const { return m_count; }
+
+		inline size_t GetCellCount() const { return m_cells.size(); }
+
+	private:
+
+		inline int32_t ToCell( float value ) const;
+
+		// Packs the cell coordinates into a key, 21 bits per axis
+		static inline uint64_t MakeCellKey( int32_t x, int32_t y, int32_t z )
+		{
+			constexpr uint64_t MASK = ( uint64_t( 1 ) << 21 ) - 1;
+			return ( uint64_t( x ) & MASK ) | ( ( uint64_t( y ) & MASK ) << 21 ) | ( ( uint64_t( z ) & MASK ) << 42 );
+		}
+
+		// Appends the entities of the cells overlapping the box, that pass the filter, to the result
+		template<typename Filter>
+		size_t Query( const Kobe::Vector3& min, const Kobe::Vector3& max, std::vector<EntityId>& result, Filter&& filter ) const;
+
+		void RemoveFromCell( EntityId entityId );
+
+	};
+
+
+	/*
+	*	Keeps a SpatialHashGrid in sync with the world position of every Transform
+	*	Register it after the TransformSystem, so it reads world transforms that are up to date
+	*	Only the entities the TransformSystem moved since the last update are re-inserted, every transform is read again only
+	*	when the TransformSystem has updated more than once in between
+	*/
+	class SpatialGridSystem : public ISystem
+	{
+		// The grid holding every entity with a Transform
+		SpatialHashGrid				m_grid;
+
+		// The transform of each tracked entity
+		std::vector<Transform*>		m_transforms;
+
+		// The position of each entity inside of m_transforms, indexed by EntityId
+		std::vector<uint32_t>		m_trackedIndex;
+
+		// Entities tracked since the last update, inserted whether or not they moved
+		std::vector<EntityId>		m_addedEntities;
+
+		// The TransformSystem's update count as of the last update
+		uint64_t					m_transformUpdateCount;
+
+	public:
+
+		static constexpr uint64_t ID = GENERATE_ID( "SpatialGridSystem" );
+
+		static constexpr uint32_t NOT_TRACKED = 0xFFFFFFFF;
+
+		explicit SpatialGridSystem( float cellSize = 10.0f ) :
+			ISystem( ID ),
+			m_grid( cellSize ),
+			m_transforms(),
+			m_trackedIndex( MAX_ENTITY_ID + 1, NOT_TRACKED ),
+			m_addedEntities(),
+			m_transformUpdateCount( 0 )
+		{}
+
+		virtual ~SpatialGridSystem() {}
+
+		virtual void Update( float deltaTime ) override;
+
+		virtual void OnEntitySignatureChanged( const Entity& entity ) override;
+
+		inline const SpatialHashGrid& GetGrid() const { return m_grid; }
+
+		// Appends every entity within the passed radius of the center to the result, as of the last update
+		inline size_t QueryRadius( const Kobe::Vector3& center, float radius, std::vector<EntityId>& result ) const
+		{
+			return m_grid.QueryRadius( center, radius, result );
+		}
+
+		// Appends every entity inside of the passed axis aligned box to the result, as of the last update
+		inline size_t QueryAABB( const Kobe::Vector3& min, const Kobe::Vector3& max, std::vector<EntityId>& result ) const
+		{
+			return m_grid.QueryAABB( min, max, result );
+		}
+
+	private:
+
+		// Moves the entity to the current world position of its transform, if it is tracked
+		void UpdateEntity( EntityId entityId );
+
+	};
+
+}
+
+#endif // !SPATIALGRID_H
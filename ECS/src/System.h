@@ -6,9 +6,14 @@
 #include "ISystem.h"
 #include "Entity.h"
 #include "Component.h"
+#include "Tag.h"
+#include "World.h"
 
 #include "Utility/TemplateHelper.h"
 
+#include <algorithm>
+#include <cassert>
+#include <utility>
 #include <tuple>
 #include <vector>
 
@@ -28,15 +33,231 @@ namespace ECS {
 		// The list of Component Tuples, where each tuple is a set of components owned by the same entity
 		std::vector<ComponentTuple>			m_components;
 
+		// Tags an entity must have to be visited by ForEach
+		TagSignature						m_requiredTags;
+
+		// Tags an entity must not have to be visited by ForEach
+		TagSignature						m_excludedTags;
+
 	public:
 
-		explicit System(uint64_t systemId) : ISystem(systemId) {}
+		explicit System(uint64_t systemId) : ISystem(systemId), m_requiredTags(), m_excludedTags() {}
 		virtual ~System() {}
 
 		virtual void Update( float deltaTime ) override {}
 
+		virtual void CollectStats( SystemStats& stats ) const override
+		{
+			ISystem::CollectStats( stats );
+			stats.m_matchedCount = m_components.size();
+			stats.m_bytesUsed = m_components.size() * sizeof( ComponentTuple );
+			stats.m_bytesAllocated = m_components.capacity() * sizeof( ComponentTuple );
+		}
+
+	protected:
+
+		// Only entities with all of the passed tags will be visited by ForEach
+		template<typename ... Tags>
+		void RequireTags()
+		{
+			m_requiredTags |= MakeTagSignature<Tags ...>();
+		}
+
+		// Entities with any of the passed tags will be skipped by ForEach
+		template<typename ... Tags>
+		void ExcludeTags()
+		{
+			m_excludedTags |= MakeTagSignature<Tags ...>();
+		}
+
+		// Returns true, if the entity with the passed EntityId passes this system's tag filters
+		inline bool MatchesTags( EntityId entityId ) const
+		{
+			const TagSignature& tags = GetWorld()->GetEntityTags( entityId );
+			return ( tags & m_requiredTags ) == m_requiredTags && ( tags & m_excludedTags ).none();
+		}
+
+		// Returns the resource <T> for reading, the system must have declared it with DeclareResourceRead or DeclareResourceWrite
+		template<typename T>
+		const T* ReadResource() const
+		{
+			assert( GetResourceIndex<T>() < MAX_RESOURCES && GetResourceReads().test( GetResourceIndex<T>() ) && "Resource read without a DeclareResourceRead" );
+			return GetWorld()->template GetResource<T>();
+		}
+
+		// Returns the resource <T> for writing, the system must have declared it with DeclareResourceWrite
+		template<typename T>
+		T* WriteResource() const
+		{
+			assert( GetResourceIndex<T>() < MAX_RESOURCES && GetResourceWrites().test( GetResourceIndex<T>() ) && "Resource written without a DeclareResourceWrite" );
+			return GetWorld()->template GetResource<T>();
+		}
+
+		// Returns true, if the owning entity and every component in the passed tuple are enabled
+		inline bool IsEnabled( const ComponentTuple& componentTuple ) const
+		{
+			return GetWorld()->IsEntityEnabled( std::get<0>( componentTuple )->GetOwnerEntity() )
+				&& std::apply( []( const Components* ... c ) { return ( c->IsEnabled() && ... ); }, componentTuple );
+		}
+
+		/*
+		*	Calls the passed function with the components of every matched entity that is enabled and passes this system's tag filters
+		*	@param	Function:	Callable taking ( Components* ... )
+		*/
+		template<typename Function>
+		void ForEach( Function&& function )
+		{
+			ForEachInRange( 0, m_components.size(), std::forward<Function>( function ) );
+		}
+
+		/*
+		*	Like ForEach, but only visits the entities in the current slice, for systems using the TimeSliced update policy
+		*	Entities matched or unmatched between frames can shift between slices, so one may be visited twice or skipped for a cycle
+		*	@param	Function:	Callable taking ( Components* ... )
+		*/
+		template<typename Function>
+		void ForEachInSlice( Function&& function )
+		{
+			const size_t size = m_components.size();
+			const size_t sliceCount = GetSliceCount();
+			const size_t slice = GetCurrentSlice();
+			ForEachInRange( size * slice / sliceCount, size * ( slice + 1 ) / sliceCount, std::forward<Function>( function ) );
+		}
+
+		/*
+		*	Like ForEach, but the matched entities are split into chunks that are processed in parallel on the world's worker threads
+		*	The function is called concurrently, it must only write to the components it is passed
+		*	@param	Function:	Callable taking ( Components* ... )
+		*	@param	chunkSize:	Entities per chunk, 0 for the default. In deterministic mode DETERMINISTIC_CHUNK_SIZE is the default
+		*/
+		template<typename Function>
+		void ParallelForEach( Function&& function, size_t chunkSize = 0 )
+		{
+			const size_t size = m_components.size();
+			chunkSize = PrepareParallelLoop( chunkSize );
+			const size_t chunkCount = ( size + chunkSize - 1 ) / chunkSize;
+
+			RunChunks( chunkCount, [&]( size_t chunk )
+			{
+				ForEachInRange( chunk * chunkSize, std::min( size, ( chunk + 1 ) * chunkSize ), function );
+			} );
+		}
+
+		/*
+		*	Maps every matched entity to a value and combines the values, with the entities split into chunks processed in parallel
+		*	Each chunk is combined in order starting from 'identity', then the chunk results are combined in chunk order on the calling thread
+		*	In deterministic mode the result, including floating point rounding, is the same for any number of worker threads
+		*	@param	Map:		Callable taking ( Components* ... ), returning a T
+		*	@param	Combine:	Callable taking ( const T&, const T& ), returning a T
+		*/
+		template<typename T, typename Map, typename Combine>
+		T ParallelReduce( const T& identity, Map&& map, Combine&& combine, size_t chunkSize = 0 )
+		{
+			const size_t size = m_components.size();
+			chunkSize = PrepareParallelLoop( chunkSize );
+			const size_t chunkCount = ( size + chunkSize - 1 ) / chunkSize;
+
+			std::vector<T> partials( chunkCount, identity );
+			RunChunks( chunkCount, [&]( size_t chunk )
+			{
+				T value = identity;
+				ForEachInRange( chunk * chunkSize, std::min( size, ( chunk + 1 ) * chunkSize ), [&]( Components* ... components )
+				{
+					value = combine( value, map( components ... ) );
+				} );
+				partials[chunk] = std::move( value );
+			} );
+
+			T result = identity;
+			for ( const T& partial : partials )
+			{
+				result = combine( result, partial );
+			}
+			return result;
+		}
+
+	private:
+
+		// Sorts the matched entities in deterministic mode and returns the chunk size to use
+		size_t PrepareParallelLoop( size_t chunkSize )
+		{
+			World* world = GetWorld();
+			if ( world->IsDeterministicParallelism() )
+			{
+				// Matched entities end up in an order that depends on the history of structural changes, EntityId order does not,
+				// as long as EntityIds are assigned in a fixed order, see World::SetDeterministicParallelism
+				const auto byEntity = []( const ComponentTuple& a, const ComponentTuple& b )
+				{
+					return std::get<0>( a )->GetOwnerEntity() < std::get<0>( b )->GetOwnerEntity();
+				};
+				if ( !std::is_sorted( m_components.begin(), m_components.end(), byEntity ) )
+				{
+					SortMatchedEntities();
+				}
+				return chunkSize > 0 ? chunkSize : DETERMINISTIC_CHUNK_SIZE;
+			}
+
+			if ( chunkSize > 0 )
+			{
+				return chunkSize;
+			}
+
+			// A few chunks per thread, so threads that finish early can pick up more work
+			const size_t threads = world->GetExecutor() ? world->GetExecutor()->GetThreadCount() : 1;
+			return std::max<size_t>( 1, ( m_components.size() + threads * 4 - 1 ) / ( threads * 4 ) );
+		}
+
+		template<typename Function>
+		void RunChunks( size_t chunkCount, Function&& function )
+		{
+			ParallelExecutor* executor = GetWorld()->GetExecutor();
+			if ( executor )
+			{
+				executor->Run( chunkCount, function );
+			}
+			else
+			{
+				for ( size_t chunk = 0; chunk < chunkCount; ++chunk )
+				{
+					function( chunk );
+				}
+			}
+		}
+
+		template<typename Function>
+		void ForEachInRange( size_t begin, size_t end, Function&& function )
+		{
+			const bool bFilterTags = m_requiredTags.any() || m_excludedTags.any();
+
+			for ( size_t i = begin; i < end; ++i )
+			{
+				ComponentTuple& componentTuple = m_components[i];
+
+				if ( !IsEnabled( componentTuple ) )
+				{
+					continue;
+				}
+
+				if ( bFilterTags && !MatchesTags( std::get<0>( componentTuple )->GetOwnerEntity() ) )
+				{
+					continue;
+				}
+
+				std::apply( function, componentTuple );
+			}
+		}
+
 	private:
 
+		// Iteration then follows EntityId order, which matches the order of the compacted ComponentMap vectors
+		virtual void SortMatchedEntities() override final
+		{
+			std::sort( m_components.begin(), m_components.end(), []( const ComponentTuple& a, const ComponentTuple& b )
+			{
+				return std::get<0>( a )->GetOwnerEntity() < std::get<0>( b )->GetOwnerEntity();
+			} );
+		}
+
 		// If the passed entity's components match this system's signature, the components will be added to this system
 		// If not, then we check to see if any of the entity's components are in the system and remove them
 		virtual void OnEntitySignatureChanged( const Entity& entity ) override final
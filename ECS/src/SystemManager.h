@@ -6,6 +6,7 @@
 #include "Utility/TemplateHelper.h"
 #include "ECS_Definitions.h"
 #include "ISystem.h"
+#include "Coroutine.h"
 
 #include <array>
 
@@ -26,6 +27,11 @@ namespace ECS
 		// The world this System Manager belongs to
 		class World* m_world;
 
+#ifdef ECS_COROUTINES
+		// Coroutines resumed after the systems have updated
+		CoroutineScheduler m_coroutineScheduler;
+#endif
+
 	public:
 
 		SystemManager() : m_activeSystems(), m_systemsCounter( 0 ), m_world( nullptr )
@@ -33,6 +39,10 @@ namespace ECS
 
 		~SystemManager()
 		{
+#ifdef ECS_COROUTINES
+			// Coroutines may still point at systems, so they go first
+			m_coroutineScheduler.Clear();
+#endif
 			DeregisterAllSystems();
 		}
 
@@ -149,20 +159,56 @@ namespace ECS
 			return nullptr;
 		}
 
-		// Calls Update on all active systems, inside of this system manager
+		// Advances all active systems inside of this system manager, each system is updated as its update policy allows
 		void Update( float deltaTime )
 		{
 			for( auto* s : m_activeSystems )
 			{
 				if( s != nullptr )
-					s->Update( deltaTime );
+					s->Tick( deltaTime );
 				else
 					break;
 			}
+
+#ifdef ECS_COROUTINES
+			m_coroutineScheduler.Tick( deltaTime );
+#endif
+		}
+
+		// Adds the statistics of every active system
+		void CollectStats( WorldStats& stats ) const
+		{
+			for( uint64_t i = 0; i < m_systemsCounter; ++i )
+			{
+				if( m_activeSystems[i] != nullptr )
+				{
+					stats.m_systems.emplace_back();
+					m_activeSystems[i]->CollectStats( stats.m_systems.back() );
+				}
+			}
 		}
 
+#ifdef ECS_COROUTINES
+		inline CoroutineScheduler& GetCoroutineScheduler()
+		{
+			return m_coroutineScheduler;
+		}
+#endif
+
 	private:
 
+		// Sorts the matched entities of the system at the passed index, returns false if there is no system at the index
+		bool SortSystemEntities( uint64_t index )
+		{
+			if( index >= m_systemsCounter || m_activeSystems[index] == nullptr )
+			{
+				return false;
+			}
+
+			m_activeSystems[index]->SortMatchedEntities();
+			return true;
+		}
+
 		// Updates Systems in the manager when an entity's signature has changed update the system manager's systems
 		void OnEntitySignatureChanged( const Entity& entity )
 		{
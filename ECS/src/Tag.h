@@ -0,0 +1,40 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef TAG_H
+#define TAG_H
+
+#include "ECS_Definitions.h"
+#include "Utility/TypeIndex.h"
+
+#include <type_traits>
+
+namespace ECS
+{
+	/*
+	*	Tags are empty structs, e.g. struct Enemy {};
+	*	A tag is never allocated, it only exists as its bit in the tag signature of the entities it has been added to
+	*/
+	struct TagFamily {};
+
+	// Returns the bit index of the tag type <T>, returns MAX_TAGS if there are more tag types than bits
+	template<typename T>
+	size_t GetTagIndex()
+	{
+		static_assert( std::is_empty_v<T>, "Tags must be empty types, use a Component to store data" );
+
+		const size_t index = TypeIndex<TagFamily>::Get<T>();
+		return index < MAX_TAGS ? index : MAX_TAGS;
+	}
+
+	// Returns a tag signature with the bits of the passed tag types set
+	template<typename ... Tags>
+	TagSignature MakeTagSignature()
+	{
+		TagSignature signature;
+		( ( GetTagIndex<Tags>() < MAX_TAGS ? signature.set( GetTagIndex<Tags>() ) : signature ), ... );
+		return signature;
+	}
+
+}
+
+#endif // !TAG_H
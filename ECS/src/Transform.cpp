@@ -0,0 +1,194 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#include "Transform.h"
+
+#include <algorithm>
+
+namespace ECS
+{
+
+	void TransformSystem::Update( float /*deltaTime*/ )
+	{
+		++m_updateCount;
+		m_movedEntities.clear();
+
+		if( m_bHierarchyDirty )
+		{
+			RebuildHierarchy();
+		}
+
+		if( !m_bAnyDirty )	// Nothing has moved since the last update
+		{
+			return;
+		}
+
+		const size_t size = m_order.size();
+		for( size_t i = 0; i < size; ++i )
+		{
+			const uint32_t parentIndex = m_parentIndex[i];
+
+			// Parents are always ahead of their children, so a dirty parent has already been recomputed
+			if( parentIndex != NO_PARENT && m_dirty[parentIndex] )
+			{
+				m_dirty[i] = 1;
+			}
+
+			if( !m_dirty[i] )
+			{
+				continue;
+			}
+
+			Transform* transform = m_order[i];
+			if( parentIndex == NO_PARENT )
+			{
+				m_worldTransforms[i] = transform->m_local;
+			}
+			else
+			{
+				m_worldTransforms[i] = m_worldTransforms[parentIndex] * transform->m_local;
+			}
+			transform->m_world = m_worldTransforms[i];
+			m_movedEntities.push_back( transform->GetOwnerEntity() );
+		}
+
+		std::fill( m_dirty.begin(), m_dirty.end(), 0 );
+		m_bAnyDirty = false;
+	}
+
+	void TransformSystem::OnEntitySignatureChanged( const Entity& entity )
+	{
+		const EntityId entityId = entity.GetId();
+		if( entityId > MAX_ENTITY_ID )
+		{
+			return;
+		}
+
+		Transform* transform = nullptr;
+		for( auto* c : entity.GetComponents() )	// For all the components on the entity
+		{
+			if( c == nullptr )	// The moment we find a null component, we now we are at the end of the array, no need to continue
+			{
+				break;
+			}
+
+			if( c->GetComponentType() == Transform::ID )
+			{
+				transform = static_cast<Transform*>( c );
+				break;
+			}
+		}
+
+		Transform* previous = m_entityTransforms[entityId];
+		if( previous == transform )	// Another component changed, the hierarchy is unaffected
+		{
+			return;
+		}
+
+		if( previous != nullptr )
+		{
+			previous->m_system = nullptr;
+			previous->m_hierarchyIndex = Transform::INVALID_INDEX;
+		}
+
+		if( transform != nullptr )
+		{
+			transform->m_system = this;
+			m_maxEntityId = std::max( m_maxEntityId, entityId );
+		}
+
+		m_entityTransforms[entityId] = transform;
+		m_bHierarchyDirty = true;
+	}
+
+	void TransformSystem::RebuildHierarchy()
+	{
+		m_order.clear();
+		m_parentIndex.clear();
+
+		// Build the children of each entity as one contiguous array, with offsets indexed by EntityId
+		m_childOffsets.assign( m_maxEntityId + 2, 0 );
+		for( EntityId id = 1; id <= m_maxEntityId; ++id )
+		{
+			const Transform* transform = m_entityTransforms[id];
+			if( transform != nullptr && transform->m_parent != 0 && transform->m_parent <= m_maxEntityId && m_entityTransforms[transform->m_parent] != nullptr )
+			{
+				++m_childOffsets[transform->m_parent + 1];
+			}
+		}
+
+		for( size_t i = 1; i < m_childOffsets.size(); ++i )
+		{
+			m_childOffsets[i] += m_childOffsets[i - 1];
+		}
+
+		m_children.resize( m_childOffsets.back() );
+		std::vector<uint32_t> fill( m_childOffsets.begin(), m_childOffsets.end() - 1 );
+		for( EntityId id = 1; id <= m_maxEntityId; ++id )
+		{
+			Transform* transform = m_entityTransforms[id];
+			if( transform != nullptr && transform->m_parent != 0 && transform->m_parent <= m_maxEntityId && m_entityTransforms[transform->m_parent] != nullptr )
+			{
+				m_children[fill[transform->m_parent]++] = transform;
+			}
+		}
+
+		m_visited.assign( m_maxEntityId + 1, 0 );
+
+		// Breadth-first walk from each root, m_order doubles as the queue
+		auto walk = [this]( Transform* root )
+		{
+			size_t head = m_order.size();
+			m_order.push_back( root );
+			m_parentIndex.push_back( NO_PARENT );
+			m_visited[root->GetOwnerEntity()] = 1;
+
+			for( ; head < m_order.size(); ++head )
+			{
+				const EntityId parentId = m_order[head]->GetOwnerEntity();
+				for( uint32_t c = m_childOffsets[parentId]; c < m_childOffsets[parentId + 1]; ++c )
+				{
+					Transform* child = m_children[c];
+					if( m_visited[child->GetOwnerEntity()] )
+					{
+						continue;
+					}
+					m_visited[child->GetOwnerEntity()] = 1;
+					m_order.push_back( child );
+					m_parentIndex.push_back( static_cast<uint32_t>( head ) );
+				}
+			}
+		};
+
+		for( EntityId id = 1; id <= m_maxEntityId; ++id )
+		{
+			Transform* transform = m_entityTransforms[id];
+			if( transform != nullptr && ( transform->m_parent == 0 || transform->m_parent > m_maxEntityId || m_entityTransforms[transform->m_parent] == nullptr ) )
+			{
+				walk( transform );
+			}
+		}
+
+		// Any transform not reached is part of a parent cycle, the cycle is broken by treating it as a root
+		for( EntityId id = 1; id <= m_maxEntityId; ++id )
+		{
+			Transform* transform = m_entityTransforms[id];
+			if( transform != nullptr && !m_visited[id] )
+			{
+				walk( transform );
+			}
+		}
+
+		const size_t size = m_order.size();
+		for( size_t i = 0; i < size; ++i )
+		{
+			m_order[i]->m_hierarchyIndex = static_cast<uint32_t>( i );
+		}
+
+		m_worldTransforms.resize( size, Kobe::Matrix4() );
+		m_dirty.assign( size, 1 );
+
+		m_bHierarchyDirty = false;
+		m_bAnyDirty = size > 0;
+	}
+
+};
@@ -0,0 +1,222 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include "ECS_Definitions.h"
+#include "Entity.h"
+#include "Component.h"
+#include "ISystem.h"
+
+#include "../../Math/include/Matrix.h"
+
+#include <vector>
+
+namespace ECS
+{
+	class TransformSystem;
+
+	/*
+	*	Built-in hierarchy component, holding an entity's local transform, its parent entity and its computed local-to-world transform
+	*	The world transform is only valid after the TransformSystem has updated
+	*/
+	class Transform : public Component
+	{
+		friend class TransformSystem;
+
+		// Transform relative to the parent entity, or to the world for root entities
+		Kobe::Matrix4		m_local;
+
+		// Local-to-world transform, written by the TransformSystem
+		Kobe::Matrix4		m_world;
+
+		// The parent entity, 0 for root entities
+		EntityId			m_parent;
+
+		// The TransformSystem tracking this transform
+		TransformSystem*	m_system;
+
+		// Index of this transform inside the TransformSystem's breadth-first arrays
+		uint32_t			m_hierarchyIndex;
+
+	public:
+
+		static constexpr uint64_t ID = GENERATE_ID( "Transform" );
+
+		static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+		Transform() :
+			Component( ID ),
+			m_local(),
+			m_world(),
+			m_parent( 0 ),
+			m_system( nullptr ),
+			m_hierarchyIndex( INVALID_INDEX )
+		{}
+
+		explicit Transform( const Kobe::Matrix4& local, EntityId parent = 0 ) :
+			Component( ID ),
+			m_local( local ),
+			m_world( local ),
+			m_parent( parent ),
+			m_system( nullptr ),
+			m_hierarchyIndex( INVALID_INDEX )
+		{}
+
+		virtual ~Transform() {}
+
+		inline const Kobe::Matrix4& GetLocal() const { return m_local; }
+
+		inline const Kobe::Matrix4& GetWorld() const { return m_world; }
+
+		inline EntityId GetParent() const { return m_parent; }
+
+		// Sets the local transform, flagging this transform and its children to be recomputed
+		inline void SetLocal( const Kobe::Matrix4& local );
+
+		// Re-parents this transform, passing 0 makes it a root
+		inline void SetParent( EntityId parent );
+
+		// Translates the parent entity, a parent that was not moved along with this transform makes it a root
+		virtual void RemapEntityReferences( const std::vector<EntityId>& remap ) override
+		{
+			m_parent = m_parent < remap.size() ? remap[m_parent] : 0;
+		}
+
+	};
+
+
+	/*
+	*	Propagates local-to-world transforms down the entity hierarchy
+	*	Transforms are kept sorted breadth-first in contiguous arrays, so a parent is always computed before its children
+	*	Only transforms flagged as dirty, and their subtrees, are recomputed each update
+	*/
+	class TransformSystem : public ISystem
+	{
+		friend class Transform;
+
+		static constexpr uint32_t NO_PARENT = Transform::INVALID_INDEX;
+
+		// The transform of each entity, indexed by EntityId
+		std::vector<Transform*>		m_entityTransforms;
+
+		// Transforms in breadth-first order
+		std::vector<Transform*>		m_order;
+
+		// Index of each transform's parent inside m_order, NO_PARENT for roots
+		std::vector<uint32_t>		m_parentIndex;
+
+		// World transforms in breadth-first order, read when computing children
+		std::vector<Kobe::Matrix4>	m_worldTransforms;
+
+		// Dirty flag per transform in breadth-first order
+		std::vector<uint8_t>		m_dirty;
+
+		// Scratch buffers reused when the breadth-first order is rebuilt
+		std::vector<uint32_t>		m_childOffsets;
+		std::vector<Transform*>		m_children;
+		std::vector<uint8_t>		m_visited;
+
+		// Entities whose world transform was recomputed by the last update
+		std::vector<EntityId>		m_movedEntities;
+
+		// Number of updates run, lets readers of m_movedEntities notice the updates they missed
+		uint64_t					m_updateCount;
+
+		// The largest EntityId with a transform
+		EntityId					m_maxEntityId;
+
+		// Set when a transform is added, removed or re-parented
+		bool						m_bHierarchyDirty;
+
+		// Set when any transform has been flagged as dirty
+		bool						m_bAnyDirty;
+
+	public:
+
+		static constexpr uint64_t ID = GENERATE_ID( "TransformSystem" );
+
+		TransformSystem() :
+			ISystem( ID ),
+			m_entityTransforms( MAX_ENTITY_ID + 1, nullptr ),
+			m_movedEntities(),
+			m_updateCount( 0 ),
+			m_maxEntityId( 0 ),
+			m_bHierarchyDirty( false ),
+			m_bAnyDirty( false )
+		{}
+
+		virtual ~TransformSystem()
+		{
+			for( Transform* transform : m_order )
+			{
+				transform->m_system = nullptr;
+			}
+		}
+
+		virtual void Update( float deltaTime ) override;
+
+		virtual void OnEntitySignatureChanged( const Entity& entity ) override;
+
+		// Number of transforms in the hierarchy
+		inline size_t GetTransformCount() const { return m_order.size(); }
+
+		// The entities whose world transform changed during the last update
+		inline const std::vector<EntityId>& GetMovedEntities() const { return m_movedEntities; }
+
+		inline uint64_t GetUpdateCount() const { return m_updateCount; }
+
+	private:
+
+		// Rebuilds the breadth-first order, flagging every transform as dirty
+		void RebuildHierarchy();
+
+		inline void MarkDirty( uint32_t hierarchyIndex )
+		{
+			if( hierarchyIndex < m_dirty.size() )
+			{
+				m_dirty[hierarchyIndex] = 1;
+				m_bAnyDirty = true;
+			}
+		}
+
+		inline void MarkHierarchyDirty()
+		{
+			m_bHierarchyDirty = true;
+		}
+
+	};
+
+
+	inline void Transform::SetLocal( const Kobe::Matrix4& local )
+	{
+		m_local = local;
+		if( m_system != nullptr )
+		{
+			m_system->MarkDirty( m_hierarchyIndex );
+		}
+	}
+
+	inline void Transform::SetParent( EntityId parent )
+	{
+		if( parent == GetOwnerEntity() )	// An entity cannot be its own parent
+		{
+			parent = 0;
+		}
+
+		if( m_parent == parent )
+		{
+			return;
+		}
+
+		m_parent = parent;
+		if( m_system != nullptr )
+		{
+			m_system->MarkHierarchyDirty();
+		}
+	}
+
+}
+
+
+#endif // !TRANSFORM_H
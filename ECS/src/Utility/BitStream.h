@@ -0,0 +1,182 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef BITSTREAM_H
+#define BITSTREAM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+*	Writes values packed to the bit into the passed byte buffer, the buffer is appended to and never cleared
+*/
+class BitWriter
+{
+public:
+
+	explicit BitWriter( std::vector<uint8_t>& buffer ) :
+		m_buffer( buffer ),
+		m_scratch( 0 ),
+		m_scratchBits( 0 )
+	{}
+
+	~BitWriter()
+	{
+		Flush();
+	}
+
+	/*
+	*	Writes the lowest bits of the passed value
+	*	@param	uint32_t:	The value to write
+	*	@param	uint32_t:	The number of bits to write, between 1 and 32
+	*/
+	inline void Write( uint32_t value, uint32_t bits )
+	{
+		const uint64_t mask = ( bits >= 32 ) ? 0xFFFFFFFFull : ( ( 1ull << bits ) - 1 );
+		m_scratch |= ( static_cast<uint64_t>( value ) & mask ) << m_scratchBits;
+		m_scratchBits += bits;
+
+		while( m_scratchBits >= 8 )
+		{
+			m_buffer.push_back( static_cast<uint8_t>( m_scratch & 0xFF ) );
+			m_scratch >>= 8;
+			m_scratchBits -= 8;
+		}
+	}
+
+	inline void WriteBool( bool value )
+	{
+		Write( value ? 1 : 0, 1 );
+	}
+
+	// Writes an unsigned value in groups of 7 bits, small values take a single byte
+	inline void WriteVarUint( uint64_t value )
+	{
+		while( value >= 0x80 )
+		{
+			Write( static_cast<uint32_t>( value & 0x7F ) | 0x80, 8 );
+			value >>= 7;
+		}
+		Write( static_cast<uint32_t>( value ), 8 );
+	}
+
+	// Writes any remaining bits, padding the last byte with zeros
+	inline void Flush()
+	{
+		if( m_scratchBits > 0 )
+		{
+			m_buffer.push_back( static_cast<uint8_t>( m_scratch & 0xFF ) );
+			m_scratch = 0;
+			m_scratchBits = 0;
+		}
+	}
+
+private:
+	BitWriter( const BitWriter& ) = delete;
+	BitWriter& operator=( const BitWriter& ) = delete;
+	BitWriter( BitWriter&& ) = delete;
+	BitWriter& operator=( BitWriter&& ) = delete;
+
+	// The buffer written into
+	std::vector<uint8_t>&	m_buffer;
+
+	// Bits waiting to be written as a full byte
+	uint64_t				m_scratch;
+
+	// Number of bits held in the scratch
+	uint32_t				m_scratchBits;
+};
+
+
+/*
+*	Reads values written by a BitWriter, reading past the end of the data returns zeros and flags an overflow
+*/
+class BitReader
+{
+public:
+
+	BitReader( const uint8_t* data, size_t size ) :
+		m_data( data ),
+		m_size( size ),
+		m_position( 0 ),
+		m_scratch( 0 ),
+		m_scratchBits( 0 ),
+		m_bOverflow( false )
+	{}
+
+	/*
+	*	Reads the passed number of bits
+	*	@param	uint32_t:	The number of bits to read, between 1 and 32
+	*/
+	inline uint32_t Read( uint32_t bits )
+	{
+		while( m_scratchBits < bits )
+		{
+			uint64_t byte = 0;
+			if( m_position < m_size )
+			{
+				byte = m_data[m_position++];
+			}
+			else
+			{
+				m_bOverflow = true;
+			}
+			m_scratch |= byte << m_scratchBits;
+			m_scratchBits += 8;
+		}
+
+		const uint64_t mask = ( bits >= 32 ) ? 0xFFFFFFFFull : ( ( 1ull << bits ) - 1 );
+		const uint32_t value = static_cast<uint32_t>( m_scratch & mask );
+		m_scratch >>= bits;
+		m_scratchBits -= bits;
+		return value;
+	}
+
+	inline bool ReadBool()
+	{
+		return Read( 1 ) != 0;
+	}
+
+	inline uint64_t ReadVarUint()
+	{
+		uint64_t value = 0;
+		uint32_t shift = 0;
+		uint32_t byte = 0;
+		do
+		{
+			byte = Read( 8 );
+			value |= static_cast<uint64_t>( byte & 0x7F ) << shift;
+			shift += 7;
+		} while( ( byte & 0x80 ) && shift < 64 && !m_bOverflow );
+		return value;
+	}
+
+	// Returns true, if a read went past the end of the data
+	inline bool HasOverflowed() const { return m_bOverflow; }
+
+private:
+	BitReader( const BitReader& ) = delete;
+	BitReader& operator=( const BitReader& ) = delete;
+	BitReader( BitReader&& ) = delete;
+	BitReader& operator=( BitReader&& ) = delete;
+
+	// The data being read
+	const uint8_t*	m_data;
+
+	// Size of the data in bytes
+	size_t			m_size;
+
+	// The next byte to be read
+	size_t			m_position;
+
+	// Bits read from the data that have not been returned yet
+	uint64_t		m_scratch;
+
+	// Number of bits held in the scratch
+	uint32_t		m_scratchBits;
+
+	// Set when a read goes past the end of the data
+	bool			m_bOverflow;
+};
+
+#endif // !BITSTREAM_H
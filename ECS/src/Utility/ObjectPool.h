@@ -79,6 +79,12 @@ public:
 		return object;
 	}
 
+	// Returns the number of objects currently held by this pool
+	size_t GetPooledCount() const
+	{
+		return objects.size();
+	}
+
 	/*	
 	*	Returns the passed object to this object pool
 	*	@param	Object:		The object that will be returned to the pool, ONLY valid object pointers will be return the pool successfully
@@ -0,0 +1,36 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef TYPEINDEX_H
+#define TYPEINDEX_H
+
+#include <atomic>
+#include <cstddef>
+
+/*
+*	Hands out dense, zero based indices to types at runtime, one counter per Family
+*	The index of a type is assigned the first time it is requested and never changes afterwards
+*/
+template<typename Family>
+class TypeIndex
+{
+public:
+	TypeIndex() = delete;	// Static class, no constructor needed
+
+	template<typename T>
+	static size_t Get()
+	{
+		static const size_t index = s_counter.fetch_add( 1 );
+		return index;
+	}
+
+	// Returns the number of types that have been given an index so far
+	static size_t Count()
+	{
+		return s_counter.load();
+	}
+
+private:
+	static inline std::atomic<size_t> s_counter { 0 };
+};
+
+#endif // !TYPEINDEX_H
@@ -6,9 +6,23 @@
 #include "EntityManager.h"
 #include "ComponentManager.h"
 #include "SystemManager.h"
+#include "Resource.h"
+#include "Rollback.h"
+#include "SharedMemoryView.h"
+#include "SharedComponent.h"
+#include "EntitySpawner.h"
+#include "DoubleBuffered.h"
+#include "Reflection.h"
+#include "Parallel.h"
+#include "Events.h"
 
 #include "Utility/TemplateHelper.h"
+#include "Utility/TypeIndex.h"
 
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 namespace ECS
@@ -24,16 +38,68 @@ namespace ECS
 
 		ComponentManager* m_componentManager;
 
+		// Ring of saved frames used for rollback and resimulation, only created once rollback is enabled
+		RollbackBuffer* m_rollbackBuffer;
+
+		// Publishes component state for external tools after each Update, only created once a shared memory view is enabled
+		SharedMemoryPublisher* m_sharedMemoryPublisher;
+
+		// Used to give each shared component type a dense index into m_sharedComponentStores
+		struct SharedComponentFamily {};
+
+		// The store of each shared component type, created on first use
+		std::vector<ISharedComponentStore*> m_sharedComponentStores;
+
+		// World level resources, indexed by GetResourceIndex<T>()
+		std::vector<IResource*> m_resources;
+
+		// The event channel of each event type, indexed by TypeIndex<EventFamily>, created on first use
+		std::vector<IEventChannel*> m_eventChannels;
+
+		// Spawners used by worker threads to create entities, materialized at each sync point
+		std::vector<EntitySpawner*> m_spawners;
+
+		// Guards m_spawners, so spawners can be created from any thread
+		std::mutex m_spawnersMutex;
+
+		// Swaps the buffers of a single double buffered component
+		using SwapBuffersFunction = void( * )( Component* );
+
+		// The registered double buffered component types, swapped at the end of each Update
+		std::vector<std::pair<uint64_t, SwapBuffersFunction>> m_doubleBufferedTypes;
+
+		// EntityId translation used by MoveEntitiesFrom, indexed by the source EntityId, every entry is 0 between moves
+		std::vector<EntityId> m_moveRemap;
+
+		// Runs the jobs of systems' parallel loops, only created once worker threads are requested
+		ParallelExecutor* m_executor;
+
+		// When set, parallel loops partition and reduce as a fixed function of the matched entities, independent of the thread count
+		bool m_bDeterministicParallelism;
+
 		template<typename ... T>
 		friend struct Parser;
 
+		friend class ReplicationEncoder;
+
 	public:
 
 		// Constructs ECS system
 		World() :
 			m_enityManager( new ECS::EntityManager() ),
 			m_systemManager( new ECS::SystemManager() ),
-			m_componentManager( new ECS::ComponentManager( m_enityManager, m_systemManager ) )
+			m_componentManager( new ECS::ComponentManager( m_enityManager, m_systemManager ) ),
+			m_rollbackBuffer( nullptr ),
+			m_sharedMemoryPublisher( nullptr ),
+			m_sharedComponentStores(),
+			m_resources( MAX_RESOURCES, nullptr ),
+			m_eventChannels(),
+			m_spawners(),
+			m_spawnersMutex(),
+			m_doubleBufferedTypes(),
+			m_moveRemap(),
+			m_executor( nullptr ),
+			m_bDeterministicParallelism( false )
 		{
 			m_systemManager->SetWorld( this );
 		}
@@ -43,6 +109,48 @@ namespace ECS
 		{
 			// Each Manager will handle the destruction of their items
 
+			if ( m_rollbackBuffer )
+			{
+				delete m_rollbackBuffer;
+				m_rollbackBuffer = nullptr;
+			}
+
+			if ( m_sharedMemoryPublisher )
+			{
+				delete m_sharedMemoryPublisher;
+				m_sharedMemoryPublisher = nullptr;
+			}
+
+			for ( ISharedComponentStore* store : m_sharedComponentStores )
+			{
+				delete store, store = nullptr;
+			}
+			m_sharedComponentStores.clear();
+
+			for ( IResource* resource : m_resources )
+			{
+				delete resource, resource = nullptr;
+			}
+			m_resources.clear();
+
+			for ( IEventChannel* channel : m_eventChannels )
+			{
+				delete channel, channel = nullptr;
+			}
+			m_eventChannels.clear();
+
+			for ( EntitySpawner* spawner : m_spawners )
+			{
+				delete spawner, spawner = nullptr;
+			}
+			m_spawners.clear();
+
+			if ( m_executor )
+			{
+				delete m_executor;
+				m_executor = nullptr;
+			}
+
 			// Systems get deleted first, so when we remove components, they no longer
 			if ( m_systemManager )
 			{
@@ -69,6 +177,7 @@ namespace ECS
 		std::vector<EntityId> CreateEntities( uint64_t numberOfEntities )
 		{
 			std::vector<EntityId> createdEntities;
+			createdEntities.reserve( numberOfEntities );
 			EntityId currentEntityId;
 
 			for ( int i = 0; i < numberOfEntities; i++ )
@@ -113,9 +222,102 @@ namespace ECS
 
 		}
 
+		/*
+		*	Creates 'n' entities from the passed prefab, each receiving a copy of the prefab's components and tags
+		*	Systems are notified once per created entity, instead of once per added component
+		*	@return	vector:		The EntityIds of the created entities, entities that did not fit within the component capacity are destroyed and left out
+		*/
+		std::vector<EntityId> Instantiate( const Prefab& prefab, uint64_t numberOfEntities )
+		{
+			std::vector<EntityId> createdEntities = CreateEntities( numberOfEntities );
+			const size_t instantiated = m_componentManager->InstantiatePrefab( prefab, createdEntities );
+
+			// The entities are new, so only the trailing ones can have been skipped once the components ran out
+			for ( size_t i = instantiated; i < createdEntities.size(); ++i )
+			{
+				DestroyEntity( createdEntities[i] );
+			}
+			createdEntities.resize( instantiated );
+
+			return createdEntities;
+		}
+
+		/*
+		*	Creates a spawner, used by a single worker thread or job to create entities without waiting on the world
+		*	Safe to call from any thread, the spawner is owned by the world
+		*/
+		EntitySpawner* CreateSpawner()
+		{
+			EntitySpawner* spawner = new EntitySpawner( m_enityManager );
+
+			std::lock_guard<std::mutex> lock( m_spawnersMutex );
+			m_spawners.push_back( spawner );
+			return spawner;
+		}
+
+		/*
+		*	Materializes the spawner's pending entities, gives its unused EntityIds back and deletes it
+		*	Call at a sync point, once no thread is using the spawner
+		*/
+		void DestroySpawner( EntitySpawner* spawner )
+		{
+			{
+				std::lock_guard<std::mutex> lock( m_spawnersMutex );
+				auto it = std::find( m_spawners.begin(), m_spawners.end(), spawner );
+				if ( it == m_spawners.end() )
+				{
+					return;
+				}
+				m_spawners.erase( it );
+			}
+
+			MaterializeSpawnedEntities( *spawner );
+			m_enityManager->ReleaseReservedEntityIds( spawner->m_reservedIds );
+			delete spawner, spawner = nullptr;
+		}
+
+		/*
+		*	Creates the entities of every spawner, attaching their components and tags, systems are notified once per entity
+		*	Each spawner is then given EntityIds for the next frame, in the order the spawners were created, destroyed entities' EntityIds first
+		*	Call at a sync point, while no worker thread is using a spawner
+		*	@return	size_t:		The number of entities materialized
+		*/
+		size_t MaterializeSpawnedEntities()
+		{
+			std::lock_guard<std::mutex> lock( m_spawnersMutex );
+
+			size_t materialized = 0;
+			for ( EntitySpawner* spawner : m_spawners )
+			{
+				materialized += MaterializeSpawnedEntities( *spawner );
+			}
+
+			for ( EntitySpawner* spawner : m_spawners )
+			{
+				const uint64_t reserved = spawner->m_reservedIds.size();
+				if ( reserved < EntitySpawner::RANGE_SIZE )
+				{
+					m_enityManager->ReserveFreeEntityIds( EntitySpawner::RANGE_SIZE - reserved, spawner->m_reservedIds );
+				}
+			}
+			return materialized;
+		}
+
 		// Destroys Entity with the passed EntityId, removing all components in the process
 		void DestroyEntity( EntityId entityId )
 		{
+			for ( ISharedComponentStore* store : m_sharedComponentStores )
+			{
+				if ( store != nullptr )
+				{
+					store->Remove( entityId );
+				}
+			}
+
+#ifdef ECS_COROUTINES
+			StopCoroutines( entityId );
+#endif
+
 			m_componentManager->RemoveAllComponents( entityId );
 			m_enityManager->MarkEntityForCleanUp( entityId );
 		}
@@ -125,6 +327,146 @@ namespace ECS
 
 
 
+		/*
+		*	Moves every entity of the staging world into this world, e.g. once a loader thread has finished building a region in the staging world
+		*	Component objects are moved rather than re-created, and EntityIds stored in components are translated with RemapEntityReferences
+		*	Tags, enabled state and shared components move along, entities are destroyed in the staging world once moved
+		*	Call at a sync point, while no other thread is using either world
+		*	@param	World:	The staging world, entities that do not fit in this world, or whose components do not fit, stay in it
+		*	@param	remap:	Optional, filled with the EntityId in this world of each staging EntityId, indexed by the staging EntityId, 0 if not moved
+		*	@return	size_t:	The number of entities moved
+		*/
+		size_t MergeWorld( World& staging, std::vector<EntityId>* remap = nullptr )
+		{
+			std::vector<EntityId> stagingEntities;
+			stagingEntities.reserve( staging.m_enityManager->m_entityCounter );
+
+			for ( const auto& pair : staging.m_enityManager->m_entities )
+			{
+				if ( pair.second != nullptr )
+				{
+					stagingEntities.push_back( pair.first );
+				}
+			}
+
+			return MoveEntitiesFrom( staging, stagingEntities, remap );
+		}
+
+		/*
+		*	Moves the passed entities of the source world into this world, like MergeWorld but only for the passed entities
+		*	Entities that do not fit within this world's entity or component capacity stay in the source world, untouched
+		*	EntityIds stored in components that refer to entities which are not moved along become 0
+		*	@param	World:		The world to move the entities out of
+		*	@param	vector:		The EntityIds, in the source world, of the entities to move
+		*	@param	remap:		Optional, grown to MAX_ENTITY_ID + 1 entries if smaller, then the entry of each passed EntityId is set to
+		*						the EntityId in this world, 0 if not moved, the other entries are left as they were
+		*	@return	size_t:		The number of entities moved
+		*/
+		size_t MoveEntitiesFrom( World& source, const std::vector<EntityId>& entities, std::vector<EntityId>* remap = nullptr )
+		{
+			if ( entities.empty() )
+			{
+				return 0;
+			}
+
+			// Allocated once, only the entries of the moved entities are set and they are cleared again before returning
+			std::vector<EntityId>& entityRemap = m_moveRemap;
+			if ( entityRemap.empty() )
+			{
+				entityRemap.resize( MAX_ENTITY_ID + 1, 0 );
+			}
+
+			// The source EntityIds of the created entities, and the EntityIds created for them
+			std::vector<EntityId> sourceEntities;
+			std::vector<EntityId> createdEntities;
+			sourceEntities.reserve( entities.size() );
+			createdEntities.reserve( entities.size() );
+
+			for ( EntityId sourceId : entities )
+			{
+				if ( sourceId > MAX_ENTITY_ID || entityRemap[sourceId] != 0 || !source.m_enityManager->Exists( sourceId ) )
+				{
+					continue;
+				}
+
+				const EntityId entityId = m_enityManager->CreateEntity();
+				if ( entityId == 0 )	// This world is full
+				{
+					break;
+				}
+
+				entityRemap[sourceId] = entityId;
+				sourceEntities.push_back( sourceId );
+				createdEntities.push_back( entityId );
+
+				m_enityManager->m_entityTags[entityId] = source.m_enityManager->m_entityTags[sourceId];
+				m_enityManager->m_entityEnabled[entityId] = source.m_enityManager->m_entityEnabled[sourceId];
+			}
+
+			// MergeFrom clears the remap entries of the entities whose components did not fit
+			m_componentManager->MergeFrom( *source.m_componentManager, sourceEntities, entityRemap );
+
+			size_t moved = 0;
+			for ( size_t i = 0; i < sourceEntities.size(); ++i )
+			{
+				if ( entityRemap[sourceEntities[i]] == 0 )	// Stays in the source world, the entity created for it is not needed
+				{
+					DestroyEntity( createdEntities[i] );
+					continue;
+				}
+
+				++moved;
+			}
+
+			for ( size_t i = 0; i < source.m_sharedComponentStores.size(); ++i )
+			{
+				ISharedComponentStore* sourceStore = source.m_sharedComponentStores[i];
+				if ( sourceStore == nullptr )
+				{
+					continue;
+				}
+
+				if ( i >= m_sharedComponentStores.size() )
+				{
+					m_sharedComponentStores.resize( i + 1, nullptr );
+				}
+
+				if ( m_sharedComponentStores[i] == nullptr )
+				{
+					m_sharedComponentStores[i] = sourceStore->CreateEmpty();
+				}
+
+				m_sharedComponentStores[i]->MergeFrom( *sourceStore, sourceEntities, entityRemap );
+			}
+
+			if ( remap )
+			{
+				if ( remap->size() < MAX_ENTITY_ID + 1 )
+				{
+					remap->resize( MAX_ENTITY_ID + 1, 0 );
+				}
+
+				for ( EntityId sourceId : entities )
+				{
+					if ( sourceId <= MAX_ENTITY_ID )
+					{
+						( *remap )[sourceId] = entityRemap[sourceId];
+					}
+				}
+			}
+
+			for ( EntityId sourceId : sourceEntities )
+			{
+				if ( entityRemap[sourceId] != 0 )
+				{
+					source.DestroyEntity( sourceId );
+					entityRemap[sourceId] = 0;
+				}
+			}
+
+			return moved;
+		}
+
 		// Adds Component to entity with passed EntityId
 		template<typename T, typename ... Args>
 		T* AddComponentToEntity( EntityId entityId, Args&& ... args )
@@ -147,11 +489,260 @@ namespace ECS
 		}
 
 
-		// Registers Systems, inside of system manager
+		// Creates an owning group, keeping the storage of the passed component types co-sorted for linear multi-component iteration
+		template<typename ... Owned>
+		Group<Owned ...>* CreateGroup()
+		{
+			return m_componentManager->CreateGroup<Owned ...>();
+		}
+
+		// Returns the owning group of exactly the passed component types, returning nullptr if there is none
+		template<typename ... Owned>
+		Group<Owned ...>* GetGroup()
+		{
+			return m_componentManager->GetGroup<Owned ...>();
+		}
+
+		// Creates the resource <T> from the passed constructor arguments, replacing any existing resource of the same type
+		template<typename T, typename ... Args>
+		T* SetResource( Args&& ... args )
+		{
+			const size_t index = GetResourceIndex<T>();
+			if ( index >= MAX_RESOURCES )	// There are more resource types than supported
+			{
+				return nullptr;
+			}
+
+			Resource<T>* resource = new Resource<T>( std::forward<Args>( args ) ... );
+			delete m_resources[index];
+			m_resources[index] = resource;
+
+			return &resource->m_value;
+		}
+
+		// Returns the resource <T>, returning nullptr if it has not been set
 		template<typename T>
-		T* RegisterSystem()
+		T* GetResource()
 		{
-			return m_systemManager->RegisterSystem<T>();
+			const size_t index = GetResourceIndex<T>();
+			if ( index >= MAX_RESOURCES || m_resources[index] == nullptr )
+			{
+				return nullptr;
+			}
+
+			return &static_cast<Resource<T>*>( m_resources[index] )->m_value;
+		}
+
+		// Destroys the resource <T>
+		template<typename T>
+		void RemoveResource()
+		{
+			const size_t index = GetResourceIndex<T>();
+			if ( index < MAX_RESOURCES )
+			{
+				delete m_resources[index], m_resources[index] = nullptr;
+			}
+		}
+
+		/*
+		*	Returns the event channel of type <T>, creating it on first use
+		*	The first call for a type must not happen while systems are updating, e.g. get channels when registering systems
+		*/
+		template<typename T>
+		Events<T>* GetEvents()
+		{
+			const size_t index = TypeIndex<EventFamily>::Get<T>();
+			if ( index >= m_eventChannels.size() )
+			{
+				m_eventChannels.resize( index + 1, nullptr );
+			}
+
+			if ( m_eventChannels[index] == nullptr )
+			{
+				m_eventChannels[index] = new Events<T>();
+			}
+
+			return static_cast<Events<T>*>( m_eventChannels[index] );
+		}
+
+		// Subscribes to the events of type <T>, so they are kept and readable the frame after they were sent
+		template<typename T>
+		Events<T>* SubscribeEvents()
+		{
+			Events<T>* events = GetEvents<T>();
+			events->Subscribe();
+			return events;
+		}
+
+		template<typename T>
+		void UnsubscribeEvents()
+		{
+			GetEvents<T>()->Unsubscribe();
+		}
+
+		// Makes the events sent last frame readable, called at the start of every Update
+		void SwapEventChannels()
+		{
+			for ( IEventChannel* channel : m_eventChannels )
+			{
+				if ( channel != nullptr )
+				{
+					channel->Swap();
+				}
+			}
+		}
+
+		// Drops every pending and readable event of every channel, called when the World rolls back
+		void ClearEventChannels()
+		{
+			for ( IEventChannel* channel : m_eventChannels )
+			{
+				if ( channel != nullptr )
+				{
+					channel->Clear();
+				}
+			}
+		}
+
+		// Makes the entity with the passed EntityId reference the shared value, equal values are stored once across all entities
+		template<typename T>
+		uint32_t SetSharedComponent( EntityId entityId, const T& value )
+		{
+			return GetSharedComponentStore<T>()->Set( entityId, value );
+		}
+
+		// Returns the shared value of type <T> referenced by the entity with the passed EntityId, returning nullptr if it has none
+		template<typename T>
+		const T* GetSharedComponent( EntityId entityId )
+		{
+			return GetSharedComponentStore<T>()->Get( entityId );
+		}
+
+		// Releases the entity's reference to its shared value of type <T>
+		template<typename T>
+		void RemoveSharedComponent( EntityId entityId )
+		{
+			GetSharedComponentStore<T>()->Remove( entityId );
+		}
+
+		// Returns the store for the shared component type <T>, used to visit entities grouped by shared value
+		template<typename T>
+		SharedComponentStore<T>* GetSharedComponentStore()
+		{
+			const size_t index = TypeIndex<SharedComponentFamily>::Get<T>();
+			if ( index >= m_sharedComponentStores.size() )
+			{
+				m_sharedComponentStores.resize( index + 1, nullptr );
+			}
+
+			if ( m_sharedComponentStores[index] == nullptr )
+			{
+				m_sharedComponentStores[index] = new SharedComponentStore<T>();
+			}
+
+			return static_cast<SharedComponentStore<T>*>( m_sharedComponentStores[index] );
+		}
+
+		// Enables or disables the entity with the passed EntityId without removing any of its components
+		inline bool SetEntityEnabled( EntityId entityId, bool bEnabled )
+		{
+			return m_enityManager->SetEnabled( entityId, bEnabled );
+		}
+
+		// Returns true, if the entity with the passed EntityId is enabled
+		inline bool IsEntityEnabled( EntityId entityId ) const
+		{
+			return m_enityManager->IsEnabled( entityId );
+		}
+
+		// Adds the tag <T> to the entity with the passed EntityId, tags are only bits in the entity's tag signature
+		template<typename T>
+		bool AddTag( EntityId entityId )
+		{
+			return m_enityManager->SetTag( entityId, GetTagIndex<T>(), true );
+		}
+
+		// Removes the tag <T> from the entity with the passed EntityId
+		template<typename T>
+		bool RemoveTag( EntityId entityId )
+		{
+			return m_enityManager->SetTag( entityId, GetTagIndex<T>(), false );
+		}
+
+		// Returns true, if the entity with the passed EntityId has the tag <T>
+		template<typename T>
+		bool HasTag( EntityId entityId ) const
+		{
+			return m_enityManager->HasTag( entityId, GetTagIndex<T>() );
+		}
+
+		// Returns the tag signature of the entity with the passed EntityId
+		inline const TagSignature& GetEntityTags( EntityId entityId ) const
+		{
+			return m_enityManager->GetTags( entityId );
+		}
+
+		// Returns the EntityIds of all entities that have every one of the passed tags
+		template<typename ... Tags>
+		std::vector<EntityId> GetEntitiesWithTags() const
+		{
+			const TagSignature required = MakeTagSignature<Tags ...>();
+
+			std::vector<EntityId> entities;
+			for ( const auto& entity : m_enityManager->m_entities )
+			{
+				if ( entity.second != nullptr && ( m_enityManager->GetTags( entity.first ) & required ) == required )
+				{
+					entities.push_back( entity.first );
+				}
+			}
+			return entities;
+		}
+
+
+		/*
+		*	Subscribes to entities gaining a component of type <T>, the callback receives every such entity once per sync point
+		*	Nothing is recorded for component types without observers
+		*	@param	callback:	Called with the EntityIds, sorted, of entities that have gained <T> since the last sync point and still have it
+		*/
+		template<typename T>
+		ComponentObserverId OnAdded( ComponentObserverCallback callback )
+		{
+			CanConvert_From<T, Component>();
+			return m_componentManager->GetObservers().Subscribe( T::ID, true, std::move( callback ) );
+		}
+
+		/*
+		*	Subscribes to entities losing their component of type <T>, including destroyed entities, once per sync point
+		*	@param	callback:	Called with the EntityIds, sorted, of entities that have lost <T> since the last sync point and do not have it anymore
+		*/
+		template<typename T>
+		ComponentObserverId OnRemoved( ComponentObserverCallback callback )
+		{
+			CanConvert_From<T, Component>();
+			return m_componentManager->GetObservers().Subscribe( T::ID, false, std::move( callback ) );
+		}
+
+		void RemoveComponentObserver( ComponentObserverId observerId )
+		{
+			m_componentManager->GetObservers().Unsubscribe( observerId );
+		}
+
+		// Hands each component observer its batch, called at the start of every Update
+		void FlushComponentObservers()
+		{
+			ComponentManager* componentManager = m_componentManager;
+			componentManager->GetObservers().Flush( [componentManager]( EntityId entityId, uint64_t componentType )
+			{
+				return componentManager->HasComponentType( entityId, componentType );
+			} );
+		}
+
+		// Registers Systems, inside of system manager
+		template<typename T, typename ... Args>
+		T* RegisterSystem( Args&& ... args )
+		{
+			return m_systemManager->RegisterSystem<T>( std::forward<Args>( args ) ... );
 		}
 
 		// Deregisters system from system manager
@@ -172,11 +763,319 @@ namespace ECS
 		// Update World Systems
 		void Update( float deltaTime )
 		{
-			m_systemManager->Update( deltaTime );
+			Step( deltaTime );
+
+			if ( m_sharedMemoryPublisher )
+			{
+				m_sharedMemoryPublisher->OnWorldUpdated();
+			}
+		}
+
+		/*
+		*	Registers the component type <T>, derived from DoubleBuffered, so its buffers are swapped at the end of each Update
+		*/
+		template<typename T>
+		void RegisterDoubleBuffered()
+		{
+			CanConvert_From<T, Component>();
+
+			for ( const auto& type : m_doubleBufferedTypes )
+			{
+				if ( type.first == T::ID )
+				{
+					return;
+				}
+			}
+
+			m_doubleBufferedTypes.emplace_back( T::ID, []( Component* component ) { static_cast<T*>( component )->SwapBuffers(); } );
+		}
+
+		// Makes the values written this frame visible to reads, for every registered double buffered component type
+		void SwapDoubleBuffers()
+		{
+			for ( const auto& type : m_doubleBufferedTypes )
+			{
+				for ( Component* component : m_componentManager->GetComponentsOfType( type.first ) )
+				{
+					type.second( component );
+				}
+			}
+		}
+
+		/*
+		*	Appends every component of the passed reflected type, as its owning EntityId followed by its reflected fields
+		*	@return	size_t:	The number of components written, 0 if the type is not reflected
+		*/
+		size_t SerializeComponentsOfType( uint64_t componentType, std::vector<uint8_t>& out )
+		{
+			const TypeInfo* info = TypeRegistry::Find( componentType );
+			if ( info == nullptr )
+			{
+				return 0;
+			}
+
+			const std::vector<Component*>& components = m_componentManager->GetComponentsOfType( componentType );
+			out.reserve( out.size() + components.size() * ( sizeof( EntityId ) + info->m_size ) );
+			for ( const Component* component : components )
+			{
+				FieldSerializer<EntityId>::Write( component->GetOwnerEntity(), out );
+				SerializeComponent( *info, *component, out );
+			}
+			return components.size();
+		}
+
+		/*
+		*	Returns a snapshot of the entity, component and system counts and the memory used by the World's storage
+		*	Use WorldStats::ToJson to dump it, must not be called while systems are updating
+		*/
+		WorldStats GetStats()
+		{
+			WorldStats stats;
+			m_enityManager->CollectStats( stats );
+			m_componentManager->CollectStats( stats );
+			m_systemManager->CollectStats( stats );
+
+			for ( const ISharedComponentStore* store : m_sharedComponentStores )
+			{
+				if ( store != nullptr )
+				{
+					stats.m_sharedStores.push_back( { store->GetValueCount(), store->GetSlotCount() } );
+				}
+			}
+
+			for ( const IResource* resource : m_resources )
+			{
+				stats.m_resourceCount += resource != nullptr ? 1 : 0;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock( m_spawnersMutex );
+				for ( const EntitySpawner* spawner : m_spawners )
+				{
+					stats.m_entitiesPendingSpawn += spawner->GetPendingCount();
+				}
+			}
+
+			// Entities and the component array are allocated up front, for the full capacity
+			const uint64_t entityBytesUsed = m_enityManager->m_entityCounter * sizeof( Entity );
+			const uint64_t componentArrayBytesUsed = stats.m_componentCount * sizeof( Component* );
+			stats.m_bytesUsed = entityBytesUsed + componentArrayBytesUsed;
+			stats.m_bytesAllocated = stats.m_entityBytes + stats.m_componentArrayBytes;
+
+			for ( const ComponentTypeStats& type : stats.m_componentTypes )
+			{
+				stats.m_bytesUsed += type.m_bytesUsed;
+				stats.m_bytesAllocated += type.m_bytesAllocated;
+			}
+
+			for ( const SystemStats& system : stats.m_systems )
+			{
+				stats.m_bytesUsed += system.m_bytesUsed;
+				stats.m_bytesAllocated += system.m_bytesAllocated;
+			}
+
+			return stats;
+		}
+
+		/*
+		*	Sets the number of worker threads used by systems' parallel loops, in addition to the thread calling Update
+		*	0 runs parallel loops on the calling thread only, must not be called while systems are updating
+		*/
+		void SetWorkerThreadCount( uint32_t workerCount )
+		{
+			delete m_executor;
+			m_executor = workerCount > 0 ? new ParallelExecutor( workerCount ) : nullptr;
+		}
+
+		inline ParallelExecutor* GetExecutor() const { return m_executor; }
+
+		/*
+		*	In deterministic mode, parallel loops visit entities in EntityId order, split them into chunks of a fixed size and combine
+		*	reductions in chunk order, so results are bit-identical for any number of worker threads, e.g. for lockstep replays
+		*	This only holds while EntityIds are assigned in a fixed order: spawners must be created from the thread owning the world,
+		*	and must not create more than EntitySpawner::RANGE_SIZE entities between sync points, past that they race for EntityIds
+		*/
+		inline void SetDeterministicParallelism( bool bDeterministic ) { m_bDeterministicParallelism = bDeterministic; }
+
+		inline bool IsDeterministicParallelism() const { return m_bDeterministicParallelism; }
+
+		/*
+		*	Runs the incremental storage compaction pass for up to the passed number of seconds, e.g. once per frame between Updates
+		*	Closes holes left by removed components and re-sorts component storage and system iteration by EntityId, see ComponentManager::Compact
+		*	@return	bool:	Returns true, if a full pass was completed during this call
+		*/
+		bool CompactStorage( float timeBudget )
+		{
+			return m_componentManager->Compact( timeBudget );
+		}
+
+		/*
+		*	Update World Systems with the delta time of the passed clock, e.g. an EngineClock after its UpdateFrameTicks
+		*	Templated on the clock, so the ECS does not have to link against the Timer library
+		*/
+		template<typename Clock>
+		void UpdateFromClock( const Clock& clock )
+		{
+			Update( clock.GetDeltaTime() );
+		}
+
+#ifdef ECS_COROUTINES
+		/*
+		*	Starts a coroutine, it runs until its first co_await and is then resumed by the SystemManager after the systems update
+		*	@param	owner:	The entity the coroutine belongs to, it is stopped when the entity is destroyed, 0 for none
+		*/
+		void StartCoroutine( Task task, EntityId owner = 0 )
+		{
+			m_systemManager->GetCoroutineScheduler().Start( std::move( task ), owner );
+		}
+
+		// Stops every coroutine belonging to the passed entity
+		void StopCoroutines( EntityId owner )
+		{
+			m_systemManager->GetCoroutineScheduler().Stop( owner );
+		}
+#endif
+
+		/*
+		*	Enables publishing of component state into a named shared memory region after each Update, read by a SharedMemoryReader in another process
+		*	Every publish copies all registered fields, reduce the cost with SharedMemoryPublisher::SetPublishInterval
+		*	@param	name:		The name of the region, e.g. "/ecs_world"
+		*	@param	frameBytes:	Bytes reserved for each published frame, the region holds two
+		*	Calling this again has no effect
+		*/
+		SharedMemoryPublisher* EnableSharedMemoryView( const std::string& name, size_t frameBytes )
+		{
+			if ( m_sharedMemoryPublisher == nullptr )
+			{
+				m_sharedMemoryPublisher = new SharedMemoryPublisher( m_componentManager, name, frameBytes );
+			}
+			return m_sharedMemoryPublisher;
+		}
+
+		// Registers the component type <T> for the shared memory view, only the passed member fields are published
+		template<typename T, typename ... Fields>
+		void RegisterSharedMemoryComponent( Fields T::* ... fields )
+		{
+			if ( m_sharedMemoryPublisher )
+			{
+				m_sharedMemoryPublisher->RegisterComponent<T, Fields ...>( fields ... );
+			}
+		}
+
+		// Enables rollback, keeping a ring of the last 'numberOfFrames' saved frames. Calling this again has no effect
+		RollbackBuffer* EnableRollback( size_t numberOfFrames )
+		{
+			if ( m_rollbackBuffer == nullptr )
+			{
+				m_rollbackBuffer = new RollbackBuffer( m_componentManager, numberOfFrames );
+			}
+			return m_rollbackBuffer;
+		}
+
+		// Registers the component type <T> for rollback, only the passed member fields are saved and restored
+		template<typename T, typename ... Fields>
+		void RegisterRollbackComponent( Fields T::* ... fields )
+		{
+			if ( m_rollbackBuffer )
+			{
+				m_rollbackBuffer->RegisterComponent<T, Fields ...>( fields ... );
+			}
+		}
+
+		// Saves the state of the rollback components for this frame, returning the saved frame number
+		uint64_t SaveRollbackFrame()
+		{
+			return m_rollbackBuffer ? m_rollbackBuffer->SaveFrame() : 0;
+		}
+
+		// Restores the state of the rollback components saved at the passed frame number, pending events are dropped
+		bool Rollback( uint64_t frame )
+		{
+			if ( m_rollbackBuffer == nullptr || !m_rollbackBuffer->RestoreFrame( frame ) )
+			{
+				return false;
+			}
+
+			ClearEventChannels();
+			return true;
+		}
+
+		/*
+		*	Restores the passed frame and re-runs the systems up to the latest saved frame, saving each frame again as it is re-simulated
+		*	Each re-simulated frame is stepped like Update, pending events are dropped first, so only events sent while re-simulating are seen
+		*	@param	uint64_t:	The frame number to rewind to
+		*	@param	float:		The delta time used for each re-simulated frame
+		*	@param	function:	Optional callback, invoked with the frame number before each re-simulated update, used to re-apply inputs
+		*	@return	bool:	Returns true, if the frame was still held in the ring and the simulation was re-run. Returns false, if otherwise
+		*/
+		bool Resimulate( uint64_t frame, float deltaTime, const std::function<void( uint64_t )>& beforeUpdate = nullptr )
+		{
+			if ( m_rollbackBuffer == nullptr )
+			{
+				return false;
+			}
+
+			const uint64_t latestFrame = m_rollbackBuffer->GetLatestFrame();
+			if ( !m_rollbackBuffer->RestoreFrame( frame ) )
+			{
+				return false;
+			}
+
+			ClearEventChannels();
+
+			for ( uint64_t f = frame; f < latestFrame; ++f )
+			{
+				if ( beforeUpdate )
+				{
+					beforeUpdate( f );
+				}
+
+				Step( deltaTime );
+				m_rollbackBuffer->SaveFrame();
+			}
+
+			return true;
 		}
 
 	private:
 
+		// Runs one frame of the simulation, shared by Update and Resimulate
+		void Step( float deltaTime )
+		{
+			// The start of the frame is the sync point for batched component observers and event channels
+			FlushComponentObservers();
+			SwapEventChannels();
+
+			m_systemManager->Update( deltaTime );
+
+			SwapDoubleBuffers();
+		}
+
+		// Materializes the pending entities of a single spawner, entities that do not fit are dropped along with their components
+		size_t MaterializeSpawnedEntities( EntitySpawner& spawner )
+		{
+			size_t materialized = 0;
+			for ( EntitySpawner::PendingEntity& pending : spawner.m_pending )
+			{
+				if ( !m_enityManager->CreateReservedEntity( pending.m_entityId ) )	// This world is full
+				{
+					for ( Component* component : pending.m_components )
+					{
+						delete component, component = nullptr;
+					}
+					m_enityManager->ReleaseReservedEntityIds( pending.m_entityId, 1 );
+					continue;
+				}
+
+				m_enityManager->m_entityTags[pending.m_entityId] = pending.m_tags;
+				m_componentManager->AttachComponents( pending.m_entityId, pending.m_components );
+				++materialized;
+			}
+			spawner.m_pending.clear();
+
+			return materialized;
+		}
+
 
 		// Recursively adds components to the entity with the passed id
 		template<size_t INDEX, typename ComponentClass, typename ... Components>
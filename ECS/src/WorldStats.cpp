@@ -0,0 +1,85 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#include "WorldStats.h"
+
+#include <cstdio>
+
+namespace ECS
+{
+	namespace
+	{
+		inline void AppendField( std::string& json, const char* name, uint64_t value, bool bComma = true )
+		{
+			char buffer[96];
+			std::snprintf( buffer, sizeof( buffer ), "\"%s\":%llu%s", name, static_cast<unsigned long long>( value ), bComma ? "," : "" );
+			json += buffer;
+		}
+	}
+
+	std::string WorldStats::ToJson() const
+	{
+		std::string json;
+		json.reserve( 512 + 160 * ( m_componentTypes.size() + m_systems.size() ) );
+
+		json += "{\"entities\":{";
+		AppendField( json, "count", m_entityCount );
+		AppendField( json, "capacity", m_entityCapacity );
+		AppendField( json, "highestId", m_highestEntityId );
+		AppendField( json, "freeIds", m_freeEntityIds );
+		AppendField( json, "pooled", m_pooledEntities );
+		AppendField( json, "pendingCleanUp", m_entitiesPendingCleanUp );
+		AppendField( json, "pendingSpawn", m_entitiesPendingSpawn );
+		AppendField( json, "bytes", m_entityBytes, false );
+
+		json += "},\"components\":{";
+		AppendField( json, "count", m_componentCount );
+		AppendField( json, "capacity", m_componentCapacity );
+		AppendField( json, "pendingCleanUp", m_componentsPendingCleanUp );
+		AppendField( json, "arrayBytes", m_componentArrayBytes );
+		json += "\"types\":[";
+		for( size_t i = 0; i < m_componentTypes.size(); ++i )
+		{
+			const ComponentTypeStats& type = m_componentTypes[i];
+			json += i > 0 ? ",{" : "{";
+			AppendField( json, "type", type.m_componentType );
+			AppendField( json, "count", type.m_count );
+			AppendField( json, "size", type.m_componentSize );
+			AppendField( json, "bytesUsed", type.m_bytesUsed );
+			AppendField( json, "bytesAllocated", type.m_bytesAllocated );
+			json += type.m_bGrouped ? "\"grouped\":true}" : "\"grouped\":false}";
+		}
+
+		json += "]},\"systems\":[";
+		for( size_t i = 0; i < m_systems.size(); ++i )
+		{
+			const SystemStats& system = m_systems[i];
+			json += i > 0 ? ",{" : "{";
+			AppendField( json, "id", system.m_systemId );
+			AppendField( json, "matched", system.m_matchedCount );
+			AppendField( json, "bytesUsed", system.m_bytesUsed );
+			AppendField( json, "bytesAllocated", system.m_bytesAllocated, false );
+			json += "}";
+		}
+
+		json += "],\"sharedStores\":[";
+		for( size_t i = 0; i < m_sharedStores.size(); ++i )
+		{
+			json += i > 0 ? ",{" : "{";
+			AppendField( json, "values", m_sharedStores[i].m_valueCount );
+			AppendField( json, "slots", m_sharedStores[i].m_slotCount, false );
+			json += "}";
+		}
+
+		json += "],";
+		AppendField( json, "resources", m_resourceCount );
+		AppendField( json, "bytesUsed", m_bytesUsed );
+		AppendField( json, "bytesAllocated", m_bytesAllocated );
+
+		char buffer[64];
+		std::snprintf( buffer, sizeof( buffer ), "\"fragmentation\":%.4f}", GetFragmentation() );
+		json += buffer;
+
+		return json;
+	}
+
+}
@@ -0,0 +1,106 @@
+// MIT License, Copyright (c) 2022 Malik Allen
+
+#ifndef WORLDSTATS_H
+#define WORLDSTATS_H
+
+#include "ECS_Definitions.h"
+
+#include <string>
+#include <vector>
+
+namespace ECS
+{
+	/*
+	*	Memory and usage of a single component type
+	*	Bytes used count the live components and their ComponentMap entries, bytes allocated add the spare capacity of the ComponentMap vector
+	*/
+	struct ComponentTypeStats
+	{
+		uint64_t	m_componentType = 0;
+
+		uint64_t	m_count = 0;
+
+		// sizeof the component type, 0 if no component of the type was created through a typed API
+		uint64_t	m_componentSize = 0;
+
+		uint64_t	m_bytesUsed = 0;
+		uint64_t	m_bytesAllocated = 0;
+
+		// True, if the type is owned by a group
+		bool		m_bGrouped = false;
+	};
+
+	struct SystemStats
+	{
+		uint64_t	m_systemId = 0;
+
+		// Number of entities matching the system's signature
+		uint64_t	m_matchedCount = 0;
+
+		// Bytes taken by the system's matched component tuples, used and allocated
+		uint64_t	m_bytesUsed = 0;
+		uint64_t	m_bytesAllocated = 0;
+	};
+
+	// A shared component store, free slots are released values waiting for reuse
+	struct SharedStoreStats
+	{
+		uint64_t	m_valueCount = 0;
+		uint64_t	m_slotCount = 0;
+	};
+
+	/*
+	*	A snapshot of a World's memory and usage, taken with World::GetStats
+	*	Bytes are estimates from the sizes of the ECS's own storage, allocator overhead and memory owned by components themselves is not included
+	*/
+	struct WorldStats
+	{
+		// Entity slots
+		uint64_t	m_entityCount = 0;
+		uint64_t	m_entityCapacity = 0;
+		uint64_t	m_highestEntityId = 0;
+		uint64_t	m_freeEntityIds = 0;
+
+		// Entity objects kept in the entity pool for reuse
+		uint64_t	m_pooledEntities = 0;
+
+		// Destroyed entities and removed components waiting for CleanUp
+		uint64_t	m_entitiesPendingCleanUp = 0;
+		uint64_t	m_componentsPendingCleanUp = 0;
+
+		// Entities created by spawners, waiting for MaterializeSpawnedEntities
+		uint64_t	m_entitiesPendingSpawn = 0;
+
+		// Bytes taken by Entity objects, live, pooled and pending clean up, and by the per EntityId tag and enabled arrays
+		uint64_t	m_entityBytes = 0;
+
+		// Component slots
+		uint64_t	m_componentCount = 0;
+		uint64_t	m_componentCapacity = 0;
+
+		// Bytes taken by the fixed size array of every component, allocated up front for the full capacity
+		uint64_t	m_componentArrayBytes = 0;
+
+		uint64_t	m_resourceCount = 0;
+
+		std::vector<ComponentTypeStats>	m_componentTypes;
+		std::vector<SystemStats>		m_systems;
+		std::vector<SharedStoreStats>	m_sharedStores;
+
+		// Totals over everything above
+		uint64_t	m_bytesUsed = 0;
+		uint64_t	m_bytesAllocated = 0;
+
+		// The share of allocated bytes that is not in use, from 0 to 1
+		inline double GetFragmentation() const
+		{
+			return m_bytesAllocated > 0 ? 1.0 - static_cast<double>( m_bytesUsed ) / static_cast<double>( m_bytesAllocated ) : 0.0;
+		}
+
+		// Writes the statistics as a JSON object
+		std::string ToJson() const;
+	};
+
+}
+
+#endif // !WORLDSTATS_H